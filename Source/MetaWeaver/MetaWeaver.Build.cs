@@ -40,6 +40,9 @@ public class MetaWeaver : ModuleRules
             "WorkspaceMenuStructure",
             "AssetTools",
             "DeveloperSettings",
+            "Json",
+            "SourceControl",
+            "DirectoryWatcher",
         });
     }
 }
@@ -17,6 +17,7 @@
 #include "Framework/Docking/TabManager.h"
 #include "MetaWeaverCommands.h"
 #include "MetaWeaverLogging.h"
+#include "MetaWeaverMetadataStore.h"
 #include "MetaWeaverStyle.h"
 #include "SMetaWeaverBulkEditor.h"
 #include "SMetaWeaverEditor.h"
@@ -82,6 +83,10 @@ void FMetaWeaverModule::StartupModule()
 
     // Ensure our tabs are closed before major subsystems tear down to avoid late delegate removals
     PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FMetaWeaverModule::OnPreExit);
+
+    // Undo/redo restores metadata behind the store's back, so the metadata stamps must observe it
+    ObjectTransactedHandle =
+        FCoreUObjectDelegates::OnObjectTransacted.AddStatic(&FMetaWeaverMetadataStore::OnObjectTransacted);
 }
 
 void FMetaWeaverModule::ShutdownModule()
@@ -110,6 +115,11 @@ void FMetaWeaverModule::ShutdownModule()
     {
         FCoreDelegates::OnPreExit.Remove(PreExitHandle);
     }
+    if (ObjectTransactedHandle.IsValid())
+    {
+        FCoreUObjectDelegates::OnObjectTransacted.Remove(ObjectTransactedHandle);
+    }
+    FMetaWeaverMetadataStore::ReleaseBackend();
 
     UE_LOG(LogMetaWeaver, Log, TEXT("MetaWeaver module shutting down"));
 }
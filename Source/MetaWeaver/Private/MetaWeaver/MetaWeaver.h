@@ -48,4 +48,5 @@ private:
 
     FDelegateHandle ToolMenusStartupHandle;
     FDelegateHandle PreExitHandle;
+    FDelegateHandle ObjectTransactedHandle;
 };
@@ -16,6 +16,8 @@
 #include "CoreMinimal.h"
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
 #include "MetaWeaverLogging.h"
+#include "MetaWeaverStats.h"
+#include "UObject/ObjectKey.h"
 
 namespace MetaWeaver::Aggregation
 {
@@ -55,6 +57,8 @@ namespace MetaWeaver::Aggregation
     inline void FlattenActiveSets(const TArray<TSoftObjectPtr<UMetaWeaverMetadataDefinitionSet>>& ActiveSets,
                                   TArray<UMetaWeaverMetadataDefinitionSet*>& OutSets)
     {
+        METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_FlattenActiveSets);
+
         OutSets.Reset();
         TSet<const UMetaWeaverMetadataDefinitionSet*> Visited;
 
@@ -67,88 +71,201 @@ namespace MetaWeaver::Aggregation
             }
         }
 
-        const auto SetNames = FString::JoinBy(OutSets, TEXT(", "), [](auto Set) { return Set->GetName(); });
-        UE_LOG(LogMetaWeaver, Verbose, TEXT("Active MetaWeaverDefinitionSets: %d [%s]"), OutSets.Num(), *SetNames);
+        if (UE_LOG_ACTIVE(LogMetaWeaver, Verbose))
+        {
+            const auto SetNames = FString::JoinBy(OutSets, TEXT(", "), [](auto Set) { return Set->GetName(); });
+            UE_LOG(LogMetaWeaver, Verbose, TEXT("Active MetaWeaverDefinitionSets: %d [%s]"), OutSets.Num(), *SetNames);
+        }
+    }
+
+    /**
+     * A parameter set copied out of its owning definition set.
+     * Snapshots are held by the compiled registry so that it does not keep the definition assets alive.
+     */
+    struct FFlattenedParameterSet
+    {
+        /** Name of the definition set that declared the parameter set. Only used for diagnostics. */
+        FString SetName;
+
+        /** Index of the parameter set within the declaring definition set. Only used for diagnostics. */
+        int32 Index{ 0 };
+
+        FMetaWeaverObjectParameterSet ParameterSet;
+    };
+
+    /** Snapshot of a single active definition set taken when the registry was compiled. */
+    struct FCompiledSet
+    {
+        FSoftObjectPath Path;
+
+        /** Sets included by this set when it was compiled. A change to the includes requires a full recompile. */
+        TArray<FSoftObjectPath> Includes;
+
+        TArray<FFlattenedParameterSet> ParameterSets;
+    };
+
+    /** Copy the parameter sets declared directly by the definition set, in declaration order. */
+    inline void SnapshotParameterSets(const UMetaWeaverMetadataDefinitionSet* Set,
+                                      TArray<FFlattenedParameterSet>& OutParameterSets)
+    {
+        check(Set);
+        OutParameterSets.Reset(Set->ParameterSets.Num());
+        int Index{ 0 };
+        for (const auto& ParameterSet : Set->ParameterSets)
+        {
+            auto& Flattened = OutParameterSets.AddDefaulted_GetRef();
+            Flattened.SetName = Set->GetName();
+            Flattened.Index = Index++;
+            Flattened.ParameterSet = ParameterSet;
+        }
     }
 
-    inline void GatherSpecsForClassFromSets(const UClass* Class,
-                                            const TArray<UMetaWeaverMetadataDefinitionSet*>& OrderedSets,
-                                            TArray<FMetadataParameterSpec>& OutSpecs)
+    /**
+     * Index from ObjectType to the parameter sets that target it, so that resolving the specs for a class only
+     * visits the parameter sets declared for that class or its ancestors.
+     */
+    struct FParameterSetIndex
+    {
+        /** Indices into the flattened parameter sets keyed by ObjectType, each in precedence order. */
+        TMap<FObjectKey, TArray<int32>> ByObjectType;
+
+        /** Indices of the parameter sets that do not specify an ObjectType and thus apply to every class. */
+        TArray<int32> Unrestricted;
+    };
+
+    inline void BuildParameterSetIndex(const TArray<FFlattenedParameterSet>& OrderedParameterSets,
+                                       FParameterSetIndex& OutIndex)
+    {
+        OutIndex.ByObjectType.Reset();
+        OutIndex.Unrestricted.Reset();
+        for (int32 Index = 0; Index < OrderedParameterSets.Num(); ++Index)
+        {
+            if (const auto ObjectType = OrderedParameterSets[Index].ParameterSet.ObjectType.Get())
+            {
+                OutIndex.ByObjectType.FindOrAdd(FObjectKey(ObjectType)).Add(Index);
+            }
+            else
+            {
+                OutIndex.Unrestricted.Add(Index);
+            }
+        }
+    }
+
+    /**
+     * Collect the indices of the parameter sets that apply to Class by walking its super class chain.
+     * The result is sorted into precedence order so that last-writer-wins semantics are preserved.
+     */
+    inline void CollectParameterSetsForClass(const UClass* Class,
+                                             const FParameterSetIndex& Index,
+                                             TArray<int32>& OutIndices)
     {
         check(Class);
 
+        OutIndices.Reset();
+        OutIndices.Append(Index.Unrestricted);
+        for (auto Current = Class; Current; Current = Current->GetSuperClass())
+        {
+            if (const auto Found = Index.ByObjectType.Find(FObjectKey(Current)))
+            {
+                OutIndices.Append(*Found);
+            }
+        }
+        OutIndices.Sort();
+    }
+
+    /**
+     * Gather the effective spec of every key for Class. OutDeclaringTypes is parallel to OutSpecs and holds the
+     * ObjectType of the parameter set that declared each spec (empty for unrestricted parameter sets).
+     */
+    inline void GatherSpecsForClassFromParameterSets(const UClass* Class,
+                                                     const TArray<FFlattenedParameterSet>& OrderedParameterSets,
+                                                     const TArray<int32>& MatchingIndices,
+                                                     TArray<FMetadataParameterSpec>& OutSpecs,
+                                                     TArray<FTopLevelAssetPath>& OutDeclaringTypes)
+    {
+        METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_GatherSpecs);
+        check(Class);
+
         OutSpecs.Reset();
+        OutDeclaringTypes.Reset();
         TMap<FName, FMetadataParameterSpec> ByKey;
-        for (const auto Set : OrderedSets)
+        TMap<FName, FTopLevelAssetPath> DeclaringTypeByKey;
+        for (const auto MatchingIndex : MatchingIndices)
         {
-            check(Set);
-            int Index{ 0 };
-            for (const auto& ParameterSet : Set->ParameterSets)
+            const auto& Flattened = OrderedParameterSets[MatchingIndex];
+            const auto& ParameterSet = Flattened.ParameterSet;
+            const auto Index = Flattened.Index;
+            UE_LOG(LogMetaWeaver,
+                   Verbose,
+                   TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d] with "
+                        "ObjectType='%s' matched class '%s'"),
+                   *Flattened.SetName,
+                   Index,
+                   *GetNameSafe(ParameterSet.ObjectType),
+                   *GetNameSafe(Class));
+
+            const auto ObjectType = ParameterSet.ObjectType.Get();
+            const auto DeclaringType = ObjectType ? FTopLevelAssetPath(ObjectType) : FTopLevelAssetPath();
+
+            int ParameterIndex{ 0 };
+            for (const auto& Parameter : ParameterSet.Parameters)
             {
-                UE_LOG(LogMetaWeaver,
-                       Verbose,
-                       TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d] with "
-                            "ObjectType='%s' attempting to match class '%s'"),
-                       *GetNameSafe(Set),
-                       Index,
-                       *GetNameSafe(ParameterSet.ObjectType),
-                       *GetNameSafe(Class));
-
-                if (!ParameterSet.ObjectType || Class == ParameterSet.ObjectType.Get()
-                    || Class->IsChildOf(ParameterSet.ObjectType))
+                if (!Parameter.Key.IsNone())
                 {
-                    int ParameterIndex{ 0 };
-                    for (const auto& Parameter : ParameterSet.Parameters)
+                    if (ByKey.Contains(Parameter.Key))
                     {
-                        if (!Parameter.Key.IsNone())
-                        {
-                            if (ByKey.Contains(Parameter.Key))
-                            {
-                                UE_LOG(LogMetaWeaver,
-                                       Verbose,
-                                       TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
-                                            "'%s' is overriding an earlier key in specs."),
-                                       *Set->GetName(),
-                                       Index,
-                                       ParameterIndex,
-                                       *Parameter.Key.ToString());
-                            }
-                            else
-                            {
-                                UE_LOG(LogMetaWeaver,
-                                       Verbose,
-                                       TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
-                                            "'%s' has been added to specs."),
-                                       *Set->GetName(),
-                                       Index,
-                                       ParameterIndex,
-                                       *Parameter.Key.ToString());
-                            }
-                            // Last writer wins according to OrderedSets traversal order
-                            ByKey.FindOrAdd(Parameter.Key) = Parameter;
-                        }
-                        else
-                        {
-                            UE_LOG(LogMetaWeaver,
-                                   Warning,
-                                   TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
-                                        "is Empty. Ignoring."),
-                                   *Set->GetName(),
-                                   Index,
-                                   ParameterIndex);
-                        }
-                        ParameterIndex++;
+                        UE_LOG(LogMetaWeaver,
+                               Verbose,
+                               TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
+                                    "'%s' is overriding an earlier key in specs."),
+                               *Flattened.SetName,
+                               Index,
+                               ParameterIndex,
+                               *Parameter.Key.ToString());
                     }
+                    else
+                    {
+                        UE_LOG(LogMetaWeaver,
+                               Verbose,
+                               TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
+                                    "'%s' has been added to specs."),
+                               *Flattened.SetName,
+                               Index,
+                               ParameterIndex,
+                               *Parameter.Key.ToString());
+                    }
+                    // Last writer wins according to OrderedParameterSets traversal order
+                    ByKey.FindOrAdd(Parameter.Key) = Parameter;
+                    DeclaringTypeByKey.FindOrAdd(Parameter.Key) = DeclaringType;
                 }
-                Index++;
+                else
+                {
+                    UE_LOG(LogMetaWeaver,
+                           Warning,
+                           TEXT("MetaWeaverMetadataDefinitionSet[%s].ParameterSet[%d].Parameters[%d].Key "
+                                "is Empty. Ignoring."),
+                           *Flattened.SetName,
+                           Index,
+                           ParameterIndex);
+                }
+                ParameterIndex++;
             }
         }
         ByKey.GenerateValueArray(OutSpecs);
-        const auto KeyNames = FString::JoinBy(OutSpecs, TEXT(", "), [](const auto& Set) { return Set.Key.ToString(); });
-        UE_LOG(LogMetaWeaver,
-               Verbose,
-               TEXT("MetadataParameterSpec's gathered for class '%s': [%s]"),
-               *GetNameSafe(Class),
-               *KeyNames);
+        OutDeclaringTypes.Reserve(OutSpecs.Num());
+        for (const auto& Spec : OutSpecs)
+        {
+            OutDeclaringTypes.Add(DeclaringTypeByKey.FindChecked(Spec.Key));
+        }
+        if (UE_LOG_ACTIVE(LogMetaWeaver, Verbose))
+        {
+            const auto KeyNames =
+                FString::JoinBy(OutSpecs, TEXT(", "), [](const auto& Set) { return Set.Key.ToString(); });
+            UE_LOG(LogMetaWeaver,
+                   Verbose,
+                   TEXT("MetadataParameterSpec's gathered for class '%s': [%s]"),
+                   *GetNameSafe(Class),
+                   *KeyNames);
+        }
     }
 } // namespace MetaWeaver::Aggregation
@@ -0,0 +1,74 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverAssetReferences.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/PackageName.h"
+
+namespace MetaWeaver::AssetReferences
+{
+    EStatus Check(const FSoftObjectPath& Path, const UClass* AllowedClass)
+    {
+        if (Path.IsNull())
+        {
+            return EStatus::Missing;
+        }
+        else if (const auto Object = Path.ResolveObject())
+        {
+            return !AllowedClass || Object->IsA(AllowedClass) ? EStatus::Allowed : EStatus::NotAllowed;
+        }
+        else if (Path.IsSubobject())
+        {
+            // The asset registry only records top level assets
+            return EStatus::Unknown;
+        }
+        else
+        {
+            const auto& AssetRegistry = IAssetRegistry::GetChecked();
+            const auto AssetData = AssetRegistry.GetAssetByObjectPath(Path);
+            if (!AssetData.IsValid())
+            {
+                // The asset may simply not have been discovered yet: the editor is still searching, or a commandlet
+                // only scanned part of the project
+                return AssetRegistry.IsLoadingAssets() || FPackageName::DoesPackageExist(Path.GetLongPackageName())
+                    ? EStatus::Unknown
+                    : EStatus::Missing;
+            }
+            else if (!AllowedClass)
+            {
+                return EStatus::Allowed;
+            }
+            else
+            {
+                const auto AllowedClassPath = AllowedClass->GetClassPathName();
+                if (AssetData.AssetClassPath == AllowedClassPath)
+                {
+                    return EStatus::Allowed;
+                }
+                else
+                {
+                    // ReSharper disable once CppTooWideScopeInitStatement
+                    TArray<FTopLevelAssetPath> Ancestors;
+                    if (AssetRegistry.GetAncestorClassNames(AssetData.AssetClassPath, Ancestors))
+                    {
+                        return Ancestors.Contains(AllowedClassPath) ? EStatus::Allowed : EStatus::NotAllowed;
+                    }
+                    else
+                    {
+                        return EStatus::Unknown;
+                    }
+                }
+            }
+        }
+    }
+} // namespace MetaWeaver::AssetReferences
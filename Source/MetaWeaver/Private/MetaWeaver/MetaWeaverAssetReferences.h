@@ -0,0 +1,45 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Checks of AssetReference values that answer from the asset registry rather than loading the referenced asset,
+ * so validating one asset does not pull in the dependency graph of everything it references.
+ */
+namespace MetaWeaver::AssetReferences
+{
+    enum class EStatus : uint8
+    {
+        /** The referenced asset exists and is of the allowed class. */
+        Allowed,
+
+        /** The referenced asset exists but is not of the allowed class. */
+        NotAllowed,
+
+        /** No asset exists at the path. */
+        Missing,
+
+        /** The asset registry can not answer, e.g. for subobject paths or classes missing from its hierarchy. */
+        Unknown
+    };
+
+    /**
+     * Check that the path references an asset of the allowed class (any class if AllowedClass is null).
+     * Uses the object if it is already loaded, otherwise the class path and class ancestry recorded in the asset
+     * registry. Never loads anything.
+     */
+    EStatus Check(const FSoftObjectPath& Path, const UClass* AllowedClass);
+} // namespace MetaWeaver::AssetReferences
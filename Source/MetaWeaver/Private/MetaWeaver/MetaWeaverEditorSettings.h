@@ -35,4 +35,26 @@ public:
     // Note: Keys that are not applicable to the current selection are ignored.
     UPROPERTY(EditAnywhere, Config, Category = "MetaWeaver")
     TArray<FName> LastPinnedKeys;
+
+    // Keep an index of the metadata issues of every asset in the project up to date in the background.
+    UPROPERTY(EditAnywhere, Config, Category = "MetaWeaver|Issue Index", meta = (ConfigRestartRequired = true))
+    bool bEnableIssueIndex{ true };
+
+    // Time the issue index may spend validating assets per editor frame.
+    UPROPERTY(EditAnywhere,
+              Config,
+              Category = "MetaWeaver|Issue Index",
+              meta = (ClampMin = "0.1", ClampMax = "50.0", Units = "ms"))
+    float IssueIndexFrameBudgetMs{ 2.0f };
+
+    // Keep a persistent index of the metadata of every asset in the project, so it can be queried without loading.
+    UPROPERTY(EditAnywhere, Config, Category = "MetaWeaver|Metadata Index", meta = (ConfigRestartRequired = true))
+    bool bEnableMetadataIndex{ true };
+
+    // Time the metadata index may spend reading stale packages per editor frame.
+    UPROPERTY(EditAnywhere,
+              Config,
+              Category = "MetaWeaver|Metadata Index",
+              meta = (ClampMin = "0.1", ClampMax = "50.0", Units = "ms"))
+    float MetadataIndexFrameBudgetMs{ 1.0f };
 };
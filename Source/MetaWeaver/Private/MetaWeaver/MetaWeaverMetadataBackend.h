@@ -0,0 +1,56 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+
+struct FAssetData;
+class FAssetPackageData;
+class UPackage;
+
+/**
+ * Where the metadata of assets is kept. FMetaWeaverMetadataStore forwards every read and write to the backend
+ * selected in the project settings, so validation and the editors do not depend on the storage.
+ * Backends are only used on the game thread.
+ */
+class IMetaWeaverMetadataBackend
+{
+public:
+    virtual ~IMetaWeaverMetadataBackend() = default;
+
+    /** Return the tags of a loaded asset in place, or null if it has none. Valid until the next write. */
+    virtual const TMap<FName, FString>* FindTags(const UObject* Asset) = 0;
+
+    /** Return true if TryReadUnloadedTags can read the asset's tags without loading it. */
+    virtual bool CanReadUnloadedTags(const FAssetData& AssetData) = 0;
+
+    /** Copy the tags of an asset that need not be loaded. Returns false if they can not be read without loading. */
+    virtual bool TryReadUnloadedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags) = 0;
+
+    /**
+     * Apply the edits at Indexes, which all target assets of the package. OutResults is parallel to Writes and only
+     * the entries at Indexes are set. The backend records the edits with the active transaction, if any.
+     */
+    virtual void WritePackage(UPackage& Package,
+                              TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                              TConstArrayView<int32> Indexes,
+                              TArrayView<EMetaWeaverWriteResult> OutResults) = 0;
+
+    /** Return true if writes are persisted immediately rather than when the asset's package is saved. */
+    virtual bool IsPersistedOnWrite() const = 0;
+
+    /** Return a hash that changes whenever the persisted metadata of the package may have changed. */
+    virtual uint64 GetSavedVersion(FName PackageName, const FAssetPackageData& PackageData) = 0;
+};
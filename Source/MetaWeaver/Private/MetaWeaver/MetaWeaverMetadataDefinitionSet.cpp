@@ -12,6 +12,7 @@
  * limitations under the License.
  */
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverAssetReferences.h"
 #include "MetaWeaver/MetaWeaverTypes.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
 #include "Misc/DataValidation.h"
@@ -34,8 +35,7 @@ EDataValidationResult FMetadataParameterSpec::IsDataValid(FDataValidationContext
     // If DefaultValue is set, ensure it is correctly formatted for the declared Type
     if (!DefaultValue.IsEmpty())
     {
-        FString Canonical;
-        if (!FMetaWeaverValue::Canonicalize(Type, DefaultValue, Canonical))
+        if (!FMetaWeaverValue::IsValid(Type, DefaultValue))
         {
             const auto Enum = StaticEnum<EMetaWeaverValueType>();
             const auto TypeText = Enum ? Enum->GetNameStringByValue(static_cast<int64>(Type)) : TEXT("Unknown");
@@ -46,21 +46,19 @@ EDataValidationResult FMetadataParameterSpec::IsDataValid(FDataValidationContext
         }
         else if (EMetaWeaverValueType::AssetReference == Type)
         {
-            // For asset references, if resolvable, ensure it matches AllowedClass
-            const FSoftObjectPath Path(DefaultValue);
-            if (const auto Resolved = Path.TryLoad())
+            // For asset references, ensure the asset exists and matches AllowedClass without loading it
+            using MetaWeaver::AssetReferences::EStatus;
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Status = MetaWeaver::AssetReferences::Check(FSoftObjectPath(DefaultValue), AllowedClass.Get());
+            if (EStatus::NotAllowed == Status)
             {
-                if (nullptr != AllowedClass.Get() && !Resolved->IsA(AllowedClass))
-                {
-                    const auto Message =
-                        FString::Printf(TEXT("%s.DefaultValue references an asset that is not a '%s'."),
-                                        *ContextPath,
-                                        *AllowedClass->GetName());
-                    Context.AddError(FText::FromString(Message));
-                    Result = EDataValidationResult::Invalid;
-                }
+                const auto Message = FString::Printf(TEXT("%s.DefaultValue references an asset that is not a '%s'."),
+                                                     *ContextPath,
+                                                     *AllowedClass->GetName());
+                Context.AddError(FText::FromString(Message));
+                Result = EDataValidationResult::Invalid;
             }
-            else
+            else if (EStatus::Missing == Status)
             {
                 // If asset cannot be resolved in editor, warn but do not hard-fail formatting
                 const auto Message =
@@ -166,6 +164,10 @@ void FMetadataParameterSpec::PreSave()
     {
         AllowedClass = nullptr;
     }
+    if (EMetaWeaverValueType::Bool == Type)
+    {
+        bUnique = false;
+    }
     if (EMetaWeaverValueType::Enum != Type)
     {
         EnumValues.Reset();
@@ -215,7 +217,7 @@ void UMetaWeaverMetadataDefinitionSet::PreSave(const FObjectPreSaveContext SaveC
     {
         if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
         {
-            Subsystem->NotifyDefinitionSetsChanged();
+            Subsystem->NotifyDefinitionSetChanged(this);
         }
     }
 }
@@ -227,7 +229,7 @@ void UMetaWeaverMetadataDefinitionSet::PostEditChangeProperty(FPropertyChangedEv
     {
         if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
         {
-            Subsystem->NotifyDefinitionSetsChanged();
+            Subsystem->NotifyDefinitionSetChanged(this);
         }
     }
 }
@@ -43,6 +43,15 @@ struct FMetadataParameterSpec
     UPROPERTY(EditDefaultsOnly, Category = "MetaWeaver")
     bool bRequired{ false };
 
+    /**
+     * Whether every asset for which this key is defined must use a different value, such as an identifier.
+     * Values are compared in canonical form and strings ignore case. Empty values are not checked.
+     */
+    UPROPERTY(EditDefaultsOnly,
+              Category = "MetaWeaver",
+              meta = (EditCondition = "EMetaWeaverValueType::Bool!=Type", EditConditionHides))
+    bool bUnique{ false };
+
     /** If Type is AssetReference, restrict to these declared subclasses */
     UPROPERTY(EditDefaultsOnly,
               Category = "MetaWeaver",
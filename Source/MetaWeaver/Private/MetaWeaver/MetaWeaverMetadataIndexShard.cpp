@@ -0,0 +1,458 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverMetadataIndexShard.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+    constexpr uint32 ShardMagic = 0x4D574D49; // 'MWMI'
+
+    // Bump whenever the layout written by FMetaWeaverMetadataIndexShard::Write changes
+    constexpr uint32 ShardVersion = 1;
+
+    struct FShardHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 NumStrings;
+        uint32 NumStringBytes;
+        uint32 NumPackages;
+        uint32 NumAssets;
+        uint32 NumEntries;
+        uint32 Reserved;
+    };
+    static_assert(sizeof(FShardHeader) % alignof(uint64) == 0, "The package versions that follow must stay aligned");
+
+    FString ToString(const FUtf8StringView View)
+    {
+        return FString(View.Len(), View.GetData());
+    }
+
+    // Byte order of UTF-8 is code point order, so the dictionary sorts the same on every platform
+    int32 CompareBytes(const FUtf8StringView A, const FUtf8StringView B)
+    {
+        const auto Result = FMemory::Memcmp(A.GetData(), B.GetData(), FMath::Min(A.Len(), B.Len()));
+        return 0 != Result ? Result : A.Len() - B.Len();
+    }
+
+    template <typename T>
+    TConstArrayView<T> TakeColumn(const uint8*& Cursor, const uint32 Num)
+    {
+        const TConstArrayView<T> Column(reinterpret_cast<const T*>(Cursor), Num);
+        Cursor += Column.NumBytes();
+        return Column;
+    }
+
+    template <typename T>
+    void AppendColumn(TArray64<uint8>& Buffer, const TConstArrayView<T> Column)
+    {
+        Buffer.Append(reinterpret_cast<const uint8*>(Column.GetData()), Column.NumBytes());
+    }
+
+    /** Collects every string of a shard, then sorts and deduplicates them into the dictionary. */
+    class FDictionaryBuilder
+    {
+    public:
+        // Return a handle to the string, which Build resolves to its dictionary id
+        uint32 Add(const FString& String)
+        {
+            const FTCHARToUTF8 Utf8(*String, String.Len());
+            Spans.Emplace(Bytes.Num(), Utf8.Length());
+            Bytes.Append(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length());
+            return Spans.Num() - 1;
+        }
+
+        void Build()
+        {
+            TArray<int32> Order;
+            Order.Reserve(Spans.Num());
+            for (int32 Handle = 0; Handle < Spans.Num(); ++Handle)
+            {
+                Order.Add(Handle);
+            }
+            Order.Sort([this](const int32 A, const int32 B) { return CompareBytes(View(A), View(B)) < 0; });
+
+            Ids.SetNumUninitialized(Spans.Num());
+            for (const auto Handle : Order)
+            {
+                if (0 == Unique.Num() || 0 != CompareBytes(View(Unique.Last()), View(Handle)))
+                {
+                    Unique.Add(Handle);
+                }
+                Ids[Handle] = Unique.Num() - 1;
+            }
+        }
+
+        uint32 GetId(const uint32 Handle) const { return Ids[Handle]; }
+
+        void Serialize(TArray<uint32>& OutOffsets, TArray<UTF8CHAR>& OutBytes) const
+        {
+            OutOffsets.Reserve(Unique.Num() + 1);
+            for (const auto Handle : Unique)
+            {
+                OutOffsets.Add(OutBytes.Num());
+                OutBytes.Append(View(Handle).GetData(), View(Handle).Len());
+            }
+            OutOffsets.Add(OutBytes.Num());
+        }
+
+    private:
+        FUtf8StringView View(const int32 Handle) const
+        {
+            return FUtf8StringView(Bytes.GetData() + Spans[Handle].Key, Spans[Handle].Value);
+        }
+
+        // Every added string, duplicates included, until Build
+        TArray<UTF8CHAR> Bytes;
+        TArray<TPair<int32, int32>> Spans;
+
+        // One handle per distinct string in dictionary order, and the dictionary id of every handle
+        TArray<int32> Unique;
+        TArray<uint32> Ids;
+    };
+
+    struct FAssetRow
+    {
+        uint32 Path;
+        TArray<TPair<uint32, uint32>> Tags;
+    };
+
+    struct FPackageRow
+    {
+        uint32 Name;
+        uint64 Version;
+        TArray<FAssetRow> Assets;
+    };
+} // namespace
+
+FMetaWeaverMetadataIndexShard::~FMetaWeaverMetadataIndexShard()
+{
+    // The region must be unmapped before the file handle is closed
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
+
+TSharedPtr<const FMetaWeaverMetadataIndexShard> FMetaWeaverMetadataIndexShard::Open(const FString& Filename)
+{
+    const TSharedPtr<FMetaWeaverMetadataIndexShard> Shard(new FMetaWeaverMetadataIndexShard());
+
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    if (!PlatformFile.FileExists(*Filename))
+    {
+        return nullptr;
+    }
+
+    // Only the pages a query touches are read from disk
+    if (auto Mapped = PlatformFile.OpenMappedEx(*Filename); Mapped.HasValue())
+    {
+        Shard->MappedHandle = Mapped.StealValue();
+        Shard->MappedRegion.Reset(Shard->MappedHandle->MapRegion(0, Shard->MappedHandle->GetFileSize()));
+    }
+
+    auto bBound{ false };
+    if (Shard->MappedRegion.IsValid())
+    {
+        bBound = Shard->Bind(Shard->MappedRegion->GetMappedPtr(), Shard->MappedRegion->GetMappedSize());
+    }
+    else if (FFileHelper::LoadFileToArray(Shard->LoadedBytes, *Filename, FILEREAD_Silent))
+    {
+        bBound = Shard->Bind(Shard->LoadedBytes.GetData(), Shard->LoadedBytes.Num());
+    }
+
+    if (!bBound)
+    {
+        UE_LOG(LogMetaWeaver, Log, TEXT("Metadata index shard %s has an unknown format; rebuilding it"), *Filename);
+        return nullptr;
+    }
+    return Shard;
+}
+
+bool FMetaWeaverMetadataIndexShard::Write(const FString& Filename, const FMetaWeaverIndexedPackages& Packages)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_WriteMetadataIndexShard);
+
+    FDictionaryBuilder Dictionary;
+    TArray<FPackageRow> Rows;
+    Rows.Reserve(Packages.Num());
+    for (const auto& [PackageName, Package] : Packages)
+    {
+        auto& Row = Rows.Emplace_GetRef(FPackageRow{ Dictionary.Add(PackageName.ToString()), Package.Version, {} });
+        for (const auto& [AssetPath, Tags] : Package.TagsByAsset)
+        {
+            auto& Asset = Row.Assets.Emplace_GetRef(FAssetRow{ Dictionary.Add(AssetPath), {} });
+            for (const auto& [Key, Value] : Tags)
+            {
+                Asset.Tags.Emplace(Dictionary.Add(Key.ToString()), Dictionary.Add(Value));
+            }
+        }
+    }
+
+    // Resolve the handles to ids, then order every level by id, which is the order of the strings
+    Dictionary.Build();
+    for (auto& Row : Rows)
+    {
+        Row.Name = Dictionary.GetId(Row.Name);
+        for (auto& Asset : Row.Assets)
+        {
+            Asset.Path = Dictionary.GetId(Asset.Path);
+            for (auto& [Key, Value] : Asset.Tags)
+            {
+                Key = Dictionary.GetId(Key);
+                Value = Dictionary.GetId(Value);
+            }
+            Asset.Tags.Sort([](const auto& A, const auto& B) { return A.Key < B.Key; });
+        }
+        Row.Assets.Sort([](const FAssetRow& A, const FAssetRow& B) { return A.Path < B.Path; });
+    }
+    Rows.Sort([](const FPackageRow& A, const FPackageRow& B) { return A.Name < B.Name; });
+
+    TArray<uint32> StringOffsets;
+    TArray<UTF8CHAR> StringBytes;
+    Dictionary.Serialize(StringOffsets, StringBytes);
+
+    TArray<uint64> PackageVersions;
+    TArray<uint32> PackageNames;
+    TArray<uint32> PackageFirstAsset;
+    TArray<uint32> AssetPaths;
+    TArray<uint32> AssetFirstEntry;
+    TArray<uint32> EntryKeys;
+    TArray<uint32> EntryValues;
+    for (const auto& Row : Rows)
+    {
+        PackageVersions.Add(Row.Version);
+        PackageNames.Add(Row.Name);
+        PackageFirstAsset.Add(AssetPaths.Num());
+        for (const auto& Asset : Row.Assets)
+        {
+            AssetPaths.Add(Asset.Path);
+            AssetFirstEntry.Add(EntryKeys.Num());
+            for (const auto& [Key, Value] : Asset.Tags)
+            {
+                EntryKeys.Add(Key);
+                EntryValues.Add(Value);
+            }
+        }
+    }
+    PackageFirstAsset.Add(AssetPaths.Num());
+    AssetFirstEntry.Add(EntryKeys.Num());
+
+    FShardHeader Header;
+    Header.Magic = ShardMagic;
+    Header.Version = ShardVersion;
+    Header.NumStrings = StringOffsets.Num() - 1;
+    Header.NumStringBytes = StringBytes.Num();
+    Header.NumPackages = PackageNames.Num();
+    Header.NumAssets = AssetPaths.Num();
+    Header.NumEntries = EntryKeys.Num();
+    Header.Reserved = 0;
+
+    TArray64<uint8> Buffer;
+    Buffer.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    AppendColumn<uint64>(Buffer, PackageVersions);
+    AppendColumn<uint32>(Buffer, StringOffsets);
+    AppendColumn<uint32>(Buffer, PackageNames);
+    AppendColumn<uint32>(Buffer, PackageFirstAsset);
+    AppendColumn<uint32>(Buffer, AssetPaths);
+    AppendColumn<uint32>(Buffer, AssetFirstEntry);
+    AppendColumn<uint32>(Buffer, EntryKeys);
+    AppendColumn<uint32>(Buffer, EntryValues);
+    AppendColumn<UTF8CHAR>(Buffer, StringBytes);
+
+    if (!FFileHelper::SaveArrayToFile(Buffer, *Filename))
+    {
+        UE_LOG(LogMetaWeaver, Warning, TEXT("Failed to write metadata index shard %s"), *Filename);
+        return false;
+    }
+    return true;
+}
+
+FName FMetaWeaverMetadataIndexShard::GetPackageName(const int32 PackageIndex) const
+{
+    return FName(ToString(GetString(PackageNames[PackageIndex])));
+}
+
+int32 FMetaWeaverMetadataIndexShard::FindPackage(const FName PackageName) const
+{
+    const auto Id = FindString(PackageName.ToString());
+    return INDEX_NONE != Id ? Algo::BinarySearch(PackageNames, static_cast<uint32>(Id)) : INDEX_NONE;
+}
+
+bool FMetaWeaverMetadataIndexShard::FindAssetTags(const FSoftObjectPath& Asset, TMap<FName, FString>& OutTags) const
+{
+    OutTags.Reset();
+
+    const auto PackageIndex = FindPackage(Asset.GetLongPackageFName());
+    const auto PathId = INDEX_NONE != PackageIndex ? FindString(Asset.ToString()) : INDEX_NONE;
+    if (INDEX_NONE != PathId)
+    {
+        int32 Begin{ 0 };
+        int32 End{ 0 };
+        GetAssetRange(PackageIndex, Begin, End);
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Found = Algo::BinarySearch(AssetPaths.Slice(Begin, End - Begin), static_cast<uint32>(PathId));
+        if (INDEX_NONE != Found)
+        {
+            GetEntryRange(Begin + Found, Begin, End);
+            for (auto Entry = Begin; Entry < End; ++Entry)
+            {
+                OutTags.Add(FName(ToString(GetString(EntryKeys[Entry]))), ToString(GetString(EntryValues[Entry])));
+            }
+        }
+    }
+    return OutTags.Num() > 0;
+}
+
+void FMetaWeaverMetadataIndexShard::ForEachAssetWithTag(
+    const FName Key,
+    const FString* Value,
+    const TFunctionRef<void(int32 PackageIndex, const FString& AssetPath)> Visit) const
+{
+    // Strings the dictionary does not hold can not match, so a miss costs two binary searches
+    const auto KeyId = FindString(Key.ToString());
+    const auto ValueId = Value ? FindString(*Value) : INDEX_NONE;
+    if (INDEX_NONE == KeyId || (Value && INDEX_NONE == ValueId))
+    {
+        return;
+    }
+
+    for (int32 Entry = 0; Entry < EntryKeys.Num(); ++Entry)
+    {
+        if (static_cast<uint32>(KeyId) == EntryKeys[Entry]
+            && (!Value || static_cast<uint32>(ValueId) == EntryValues[Entry]))
+        {
+            // The row of an entry is the last one that starts at or before it
+            const auto AssetIndex = Algo::UpperBound(AssetFirstEntry, static_cast<uint32>(Entry)) - 1;
+            const auto PackageIndex = Algo::UpperBound(PackageFirstAsset, static_cast<uint32>(AssetIndex)) - 1;
+            if (AssetPaths.IsValidIndex(AssetIndex) && PackageNames.IsValidIndex(PackageIndex))
+            {
+                Visit(PackageIndex, ToString(GetString(AssetPaths[AssetIndex])));
+            }
+        }
+    }
+}
+
+void FMetaWeaverMetadataIndexShard::Decode(FMetaWeaverIndexedPackages& OutPackages) const
+{
+    OutPackages.Reserve(OutPackages.Num() + NumPackages());
+    for (int32 PackageIndex = 0; PackageIndex < NumPackages(); ++PackageIndex)
+    {
+        auto& Package = OutPackages.Add(GetPackageName(PackageIndex));
+        Package.Version = PackageVersions[PackageIndex];
+
+        int32 AssetBegin{ 0 };
+        int32 AssetEnd{ 0 };
+        GetAssetRange(PackageIndex, AssetBegin, AssetEnd);
+        for (auto AssetIndex = AssetBegin; AssetIndex < AssetEnd; ++AssetIndex)
+        {
+            auto& Tags = Package.TagsByAsset.Add(ToString(GetString(AssetPaths[AssetIndex])));
+            int32 EntryBegin{ 0 };
+            int32 EntryEnd{ 0 };
+            GetEntryRange(AssetIndex, EntryBegin, EntryEnd);
+            for (auto Entry = EntryBegin; Entry < EntryEnd; ++Entry)
+            {
+                Tags.Add(FName(ToString(GetString(EntryKeys[Entry]))), ToString(GetString(EntryValues[Entry])));
+            }
+        }
+    }
+}
+
+bool FMetaWeaverMetadataIndexShard::Bind(const uint8* Data, const int64 Size)
+{
+    FShardHeader Header;
+    if (!Data || Size < static_cast<int64>(sizeof(Header)))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&Header, Data, sizeof(Header));
+
+    // Every column must fit an array view, including the extra element of the First* columns
+    constexpr uint32 MaxRows = MAX_int32 - 1;
+    const auto bCountsFit = Header.NumStrings <= MaxRows && Header.NumStringBytes <= MaxRows
+        && Header.NumPackages <= MaxRows && Header.NumAssets <= MaxRows && Header.NumEntries <= MaxRows;
+    const int64 NumWords = static_cast<int64>(Header.NumStrings) + 1 + Header.NumPackages * 2ll + 1
+        + Header.NumAssets * 2ll + 1 + Header.NumEntries * 2ll;
+    const int64 ExpectedSize = sizeof(Header) + Header.NumPackages * static_cast<int64>(sizeof(uint64))
+        + NumWords * static_cast<int64>(sizeof(uint32)) + Header.NumStringBytes;
+    if (ShardMagic != Header.Magic || ShardVersion != Header.Version || !bCountsFit || ExpectedSize != Size)
+    {
+        return false;
+    }
+
+    // Offsets read from the file are not trusted; the accessors clamp every range to its column
+    auto Cursor = Data + sizeof(Header);
+    PackageVersions = TakeColumn<uint64>(Cursor, Header.NumPackages);
+    StringOffsets = TakeColumn<uint32>(Cursor, Header.NumStrings + 1);
+    PackageNames = TakeColumn<uint32>(Cursor, Header.NumPackages);
+    PackageFirstAsset = TakeColumn<uint32>(Cursor, Header.NumPackages + 1);
+    AssetPaths = TakeColumn<uint32>(Cursor, Header.NumAssets);
+    AssetFirstEntry = TakeColumn<uint32>(Cursor, Header.NumAssets + 1);
+    EntryKeys = TakeColumn<uint32>(Cursor, Header.NumEntries);
+    EntryValues = TakeColumn<uint32>(Cursor, Header.NumEntries);
+    StringBytes = TakeColumn<UTF8CHAR>(Cursor, Header.NumStringBytes);
+    return true;
+}
+
+FUtf8StringView FMetaWeaverMetadataIndexShard::GetString(const uint32 Id) const
+{
+    if (static_cast<int64>(Id) + 1 < StringOffsets.Num())
+    {
+        const auto Begin = FMath::Min<int64>(StringOffsets[Id], StringBytes.Num());
+        const auto End = FMath::Clamp<int64>(StringOffsets[Id + 1], Begin, StringBytes.Num());
+        return FUtf8StringView(StringBytes.GetData() + Begin, static_cast<int32>(End - Begin));
+    }
+    return FUtf8StringView();
+}
+
+int32 FMetaWeaverMetadataIndexShard::FindString(const FString& String) const
+{
+    const FTCHARToUTF8 Utf8(*String, String.Len());
+    const FUtf8StringView View(reinterpret_cast<const UTF8CHAR*>(Utf8.Get()), Utf8.Length());
+
+    int32 Low{ 0 };
+    int32 High{ StringOffsets.Num() - 1 };
+    while (Low < High)
+    {
+        const auto Middle = Low + (High - Low) / 2;
+        if (const auto Result = CompareBytes(GetString(Middle), View); Result < 0)
+        {
+            Low = Middle + 1;
+        }
+        else if (Result > 0)
+        {
+            High = Middle;
+        }
+        else
+        {
+            return Middle;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FMetaWeaverMetadataIndexShard::GetAssetRange(const int32 PackageIndex, int32& OutBegin, int32& OutEnd) const
+{
+    OutBegin = static_cast<int32>(FMath::Min<int64>(PackageFirstAsset[PackageIndex], AssetPaths.Num()));
+    OutEnd = static_cast<int32>(FMath::Clamp<int64>(PackageFirstAsset[PackageIndex + 1], OutBegin, AssetPaths.Num()));
+}
+
+void FMetaWeaverMetadataIndexShard::GetEntryRange(const int32 AssetIndex, int32& OutBegin, int32& OutEnd) const
+{
+    OutBegin = static_cast<int32>(FMath::Min<int64>(AssetFirstEntry[AssetIndex], EntryKeys.Num()));
+    OutEnd = static_cast<int32>(FMath::Clamp<int64>(AssetFirstEntry[AssetIndex + 1], OutBegin, EntryKeys.Num()));
+}
@@ -0,0 +1,96 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** The indexed metadata of a package: a version of its saved metadata and the tags of each asset that has any. */
+struct FMetaWeaverIndexedPackage
+{
+    // Zero if the version is unknown, so the package is read again by the next session
+    uint64 Version{ 0 };
+
+    // Object path -> key -> value
+    TMap<FString, TMap<FName, FString>> TagsByAsset;
+};
+
+using FMetaWeaverIndexedPackages = TMap<FName, FMetaWeaverIndexedPackage>;
+
+/**
+ * One shard of the project metadata index: the packages of one mount point in a columnar file that is memory-mapped
+ * rather than read, so it can be queried as soon as it is opened.
+ *
+ * Every string (package names, object paths, keys and values) is stored once in a dictionary sorted by its UTF-8
+ * bytes, and the columns hold dictionary ids. Packages are sorted by name, the assets of a package by path and the
+ * tags of an asset by key, so lookups are binary searches and a value query compares integers. A shard is immutable
+ * and rewritten as a whole; reads are safe from any thread.
+ */
+class FMetaWeaverMetadataIndexShard final
+{
+public:
+    ~FMetaWeaverMetadataIndexShard();
+
+    /** Map the shard file. Returns null if it does not exist or is not a shard of the current format. */
+    static TSharedPtr<const FMetaWeaverMetadataIndexShard> Open(const FString& Filename);
+
+    /** Encode the packages and write them to the file. Safe from any thread. */
+    static bool Write(const FString& Filename, const FMetaWeaverIndexedPackages& Packages);
+
+    int32 NumPackages() const { return PackageNames.Num(); }
+    FName GetPackageName(int32 PackageIndex) const;
+    uint64 GetPackageVersion(int32 PackageIndex) const { return PackageVersions[PackageIndex]; }
+
+    /** Return the index of the package, or INDEX_NONE if it is not indexed. */
+    int32 FindPackage(FName PackageName) const;
+
+    /** Copy the tags of the asset. Returns false if the asset has no indexed tags. */
+    bool FindAssetTags(const FSoftObjectPath& Asset, TMap<FName, FString>& OutTags) const;
+
+    /** Visit every asset that has the key, with the given value if one is passed. Only matching rows are decoded. */
+    void ForEachAssetWithTag(FName Key,
+                             const FString* Value,
+                             TFunctionRef<void(int32 PackageIndex, const FString& AssetPath)> Visit) const;
+
+    /** Decode every package of the shard. */
+    void Decode(FMetaWeaverIndexedPackages& OutPackages) const;
+
+private:
+    FMetaWeaverMetadataIndexShard() = default;
+
+    bool Bind(const uint8* Data, int64 Size);
+    FUtf8StringView GetString(uint32 Id) const;
+    int32 FindString(const FString& String) const;
+    void GetAssetRange(int32 PackageIndex, int32& OutBegin, int32& OutEnd) const;
+    void GetEntryRange(int32 AssetIndex, int32& OutBegin, int32& OutEnd) const;
+
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    // Holds the file where the platform can not map it
+    TArray64<uint8> LoadedBytes;
+
+    // Columns, in file order. First* columns have one more element than the rows they index.
+    TConstArrayView<uint64> PackageVersions;
+    TConstArrayView<uint32> StringOffsets;
+    TConstArrayView<uint32> PackageNames;
+    TConstArrayView<uint32> PackageFirstAsset;
+    TConstArrayView<uint32> AssetPaths;
+    TConstArrayView<uint32> AssetFirstEntry;
+    TConstArrayView<uint32> EntryKeys;
+    TConstArrayView<uint32> EntryValues;
+    TConstArrayView<UTF8CHAR> StringBytes;
+};
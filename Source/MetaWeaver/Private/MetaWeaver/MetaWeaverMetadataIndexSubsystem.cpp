@@ -0,0 +1,570 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverMetadataIndexSubsystem.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "MetaWeaver/MetaWeaverEditorSettings.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverMetadataIndexShard.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverMetadataIndexSubsystem)
+
+namespace
+{
+    // A shard is written once no package of it was read for this long
+    constexpr double WriteDelaySeconds = 5.0;
+
+    // ...or as soon as this many packages are pending, so a rebuild is persisted as it goes
+    constexpr int32 MaxPendingPackages = 8192;
+
+    constexpr double RetryDelaySeconds = 30.0;
+
+    /** A package read since its shard was last written. It supersedes the package's row in the mapped shard. */
+    struct FPendingPackage
+    {
+        FMetaWeaverIndexedPackage Package;
+        uint64 Serial{ 0 };
+
+        // The asset registry no longer knows any asset of the package
+        bool bRemoved{ false };
+    };
+
+    FString GetShardFilename(const FString& MountPoint)
+    {
+        const auto ShardName = MountPoint.Mid(1, MountPoint.Len() - 2);
+        return FPaths::Combine(FPaths::ProjectSavedDir(),
+                               TEXT("MetaWeaver"),
+                               TEXT("MetadataIndex"),
+                               ShardName + TEXT(".mwidx"));
+    }
+
+    FString GetTempFilename(const FString& Filename)
+    {
+        return Filename + TEXT(".tmp");
+    }
+} // namespace
+
+struct UMetaWeaverMetadataIndexSubsystem::FShard
+{
+    // Root of the packages of the shard, such as /Game/
+    FString MountPoint;
+    FString Filename;
+
+    // The shard as last written; null until the first write if there was none
+    TSharedPtr<const FMetaWeaverMetadataIndexShard> Mapped;
+
+    TMap<FName, FPendingPackage> Pending;
+    double LastChangeTime{ 0.0 };
+    double EarliestWriteTime{ 0.0 };
+
+    // The write in flight and the serial of each package it writes
+    UE::Tasks::TTask<bool> WriteTask;
+    TMap<FName, uint64> WritingSerials;
+};
+
+bool UMetaWeaverMetadataIndexSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Commandlets read the store directly and would only pay for keeping the index current
+    return !IsRunningCommandlet() && GetDefault<UMetaWeaverEditorSettings>()->bEnableMetadataIndex
+        && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMetaWeaverMetadataIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // One shard per content root of the project; engine content and engine plugins are not indexed
+    const auto ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+    TArray<FString> RootPaths;
+    FPackageName::QueryRootContentPaths(RootPaths);
+    for (const auto& RootPath : RootPaths)
+    {
+        FString ContentDir;
+        if (FPackageName::TryConvertLongPackageNameToFilename(RootPath, ContentDir)
+            && FPaths::IsUnderDirectory(FPaths::ConvertRelativePathToFull(ContentDir), ProjectDir))
+        {
+            const auto Shard = MakeShared<FShard>();
+            Shard->MountPoint = RootPath;
+            Shard->Filename = GetShardFilename(RootPath);
+            Shard->Mapped = FMetaWeaverMetadataIndexShard::Open(Shard->Filename);
+            UE_LOG(LogMetaWeaver,
+                   Log,
+                   TEXT("Metadata index of %s: %d packages mapped"),
+                   *RootPath,
+                   Shard->Mapped.IsValid() ? Shard->Mapped->NumPackages() : 0);
+            Shards.Add(Shard);
+        }
+    }
+
+    PackageSavedHandle =
+        UPackage::PackageSavedWithContextEvent.AddUObject(this, &UMetaWeaverMetadataIndexSubsystem::OnPackageSaved);
+    MetadataChangedHandle = FMetaWeaverMetadataStore::OnMetadataChanged().AddUObject(
+        this,
+        &UMetaWeaverMetadataIndexSubsystem::OnMetadataChanged);
+
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    AssetRemovedHandle =
+        AssetRegistry.OnAssetRemoved().AddUObject(this, &UMetaWeaverMetadataIndexSubsystem::OnAssetRemoved);
+    AssetRenamedHandle =
+        AssetRegistry.OnAssetRenamed().AddUObject(this, &UMetaWeaverMetadataIndexSubsystem::OnAssetRenamed);
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &UMetaWeaverMetadataIndexSubsystem::Tick));
+}
+
+void UMetaWeaverMetadataIndexSubsystem::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+
+    UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+    FMetaWeaverMetadataStore::OnMetadataChanged().Remove(MetadataChangedHandle);
+    if (const auto AssetRegistry = IAssetRegistry::Get())
+    {
+        AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
+
+    // Persist everything read this session, so the next one only has to check it
+    for (const auto& Shard : Shards)
+    {
+        if (Shard->WriteTask.IsValid())
+        {
+            Shard->WriteTask.Wait();
+            FinishWrite(*Shard);
+        }
+        if (Shard->Pending.Num() > 0)
+        {
+            BeginWrite(*Shard);
+            Shard->WriteTask.Wait();
+            FinishWrite(*Shard);
+        }
+    }
+
+    Shards.Empty();
+    StalePackages.Empty();
+    VerifyQueue.Empty();
+    VerifyCursor = 0;
+
+    Super::Deinitialize();
+}
+
+bool UMetaWeaverMetadataIndexSubsystem::GetIndexedTags(const FSoftObjectPath& Asset,
+                                                       TMap<FName, FString>& OutTags) const
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_MetadataIndexQuery);
+
+    OutTags.Reset();
+    const auto PackageName = Asset.GetLongPackageFName();
+    if (const auto Shard = FindShard(PackageName))
+    {
+        if (const auto Pending = Shard->Pending.Find(PackageName))
+        {
+            if (const auto Tags = Pending->Package.TagsByAsset.Find(Asset.ToString()))
+            {
+                OutTags = *Tags;
+            }
+        }
+        else if (Shard->Mapped.IsValid())
+        {
+            Shard->Mapped->FindAssetTags(Asset, OutTags);
+        }
+    }
+    return OutTags.Num() > 0;
+}
+
+bool UMetaWeaverMetadataIndexSubsystem::GetIndexedValue(const FSoftObjectPath& Asset,
+                                                        const FName Key,
+                                                        FString& OutValue) const
+{
+    TMap<FName, FString> Tags;
+    GetIndexedTags(Asset, Tags);
+    const auto Value = Tags.Find(Key);
+    OutValue = Value ? *Value : FString();
+    return nullptr != Value;
+}
+
+TArray<FSoftObjectPath> UMetaWeaverMetadataIndexSubsystem::FindAssetsWithKey(const FName Key) const
+{
+    return FindAssets(Key, nullptr);
+}
+
+TArray<FSoftObjectPath> UMetaWeaverMetadataIndexSubsystem::FindAssetsWithValue(const FName Key,
+                                                                               const FString& Value) const
+{
+    return FindAssets(Key, &Value);
+}
+
+bool UMetaWeaverMetadataIndexSubsystem::IsUpToDate() const
+{
+    return !bVerificationRequested && 0 == GetNumPending();
+}
+
+int32 UMetaWeaverMetadataIndexSubsystem::GetNumPending() const
+{
+    return StalePackages.Num() + VerifyQueue.Num() - VerifyCursor;
+}
+
+bool UMetaWeaverMetadataIndexSubsystem::Tick(float)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_MetadataIndexTick);
+
+    for (const auto& Shard : Shards)
+    {
+        if (Shard->WriteTask.IsValid() && Shard->WriteTask.IsCompleted())
+        {
+            FinishWrite(*Shard);
+        }
+    }
+
+    // Packages the registry has not discovered yet would look deleted
+    if (IAssetRegistry::GetChecked().IsLoadingAssets())
+    {
+        return true;
+    }
+    if (bVerificationRequested)
+    {
+        bVerificationRequested = false;
+        QueueVerification();
+    }
+
+    const auto BudgetSeconds = GetDefault<UMetaWeaverEditorSettings>()->MetadataIndexFrameBudgetMs / 1000.0;
+    const auto EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+    while (FPlatformTime::Seconds() < EndTime)
+    {
+        // Saved and changed packages go first so edits are reflected promptly
+        if (StalePackages.Num() > 0)
+        {
+            auto It = StalePackages.CreateIterator();
+            const auto PackageName = *It;
+            It.RemoveCurrent();
+            ReadPackage(PackageName);
+        }
+        else if (VerifyCursor < VerifyQueue.Num())
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto PackageName = VerifyQueue[VerifyCursor++];
+            if (IsStale(PackageName))
+            {
+                ReadPackage(PackageName);
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (VerifyQueue.Num() > 0 && VerifyCursor == VerifyQueue.Num())
+    {
+        UE_LOG(LogMetaWeaver, Log, TEXT("Metadata index checked %d packages"), VerifyQueue.Num());
+        VerifyQueue.Empty();
+        VerifyCursor = 0;
+    }
+
+    // Write a shard once its changes settle, or sooner while a rebuild piles them up
+    const auto Now = FPlatformTime::Seconds();
+    for (const auto& Shard : Shards)
+    {
+        if (!Shard->WriteTask.IsValid() && Shard->Pending.Num() > 0 && Now >= Shard->EarliestWriteTime
+            && (Shard->Pending.Num() >= MaxPendingPackages || Now - Shard->LastChangeTime >= WriteDelaySeconds))
+        {
+            BeginWrite(*Shard);
+        }
+    }
+    SET_DWORD_STAT(STAT_MetaWeaver_MetadataIndexPendingPackages, GetNumPending());
+    return true;
+}
+
+void UMetaWeaverMetadataIndexSubsystem::QueueVerification()
+{
+    FARFilter Filter;
+    for (const auto& Shard : Shards)
+    {
+        Filter.PackagePaths.Add(FName(Shard->MountPoint.LeftChop(1)));
+    }
+    Filter.bRecursivePaths = true;
+
+    // An empty filter would return every asset, including the engine's
+    TArray<FAssetData> Assets;
+    if (Filter.PackagePaths.Num() > 0)
+    {
+        IAssetRegistry::GetChecked().GetAssets(Filter, Assets);
+    }
+    TSet<FName> Packages;
+    Packages.Reserve(Assets.Num());
+    for (const auto& AssetData : Assets)
+    {
+        Packages.Add(AssetData.PackageName);
+    }
+
+    // Indexed packages the registry no longer knows were deleted while the editor was closed
+    for (const auto& Shard : Shards)
+    {
+        const auto NumIndexed = Shard->Mapped.IsValid() ? Shard->Mapped->NumPackages() : 0;
+        for (int32 PackageIndex = 0; PackageIndex < NumIndexed; ++PackageIndex)
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto PackageName = Shard->Mapped->GetPackageName(PackageIndex);
+            if (!Packages.Contains(PackageName))
+            {
+                StalePackages.Add(PackageName);
+            }
+        }
+    }
+
+    VerifyQueue = Packages.Array();
+    VerifyCursor = 0;
+}
+
+bool UMetaWeaverMetadataIndexSubsystem::IsStale(const FName PackageName) const
+{
+    const auto Shard = FindShard(PackageName);
+    if (!Shard || Shard->Pending.Contains(PackageName))
+    {
+        // Not indexed, or already read this session
+        return false;
+    }
+
+    const auto PackageIndex = Shard->Mapped.IsValid() ? Shard->Mapped->FindPackage(PackageName) : INDEX_NONE;
+    if (INDEX_NONE == PackageIndex)
+    {
+        return true;
+    }
+    else
+    {
+        const auto IndexedVersion = Shard->Mapped->GetPackageVersion(PackageIndex);
+        const auto PackageData = IAssetRegistry::GetChecked().GetAssetPackageDataCopy(PackageName);
+        return 0 == IndexedVersion || !PackageData.IsSet()
+            || IndexedVersion != FMetaWeaverMetadataStore::GetSavedMetadataVersion(PackageName, *PackageData);
+    }
+}
+
+void UMetaWeaverMetadataIndexSubsystem::ReadPackage(const FName PackageName)
+{
+    const auto Shard = FindShard(PackageName);
+    if (!Shard)
+    {
+        return;
+    }
+
+    // The index holds saved metadata, so assets that were never saved are indexed once they are
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssetsByPackageName(PackageName, Assets, /*bIncludeOnlyOnDiskAssets*/ true);
+
+    FPendingPackage Pending;
+    Pending.Serial = ++NextReadSerial;
+    Pending.bRemoved = 0 == Assets.Num();
+
+    const auto PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+    auto bComplete = PackageData.IsSet();
+    // Unsaved edits of package metadata would be stamped with the saved version, so a dirty package is read from
+    // what was saved with it instead
+    const auto Package = FindPackage(nullptr, *PackageName.ToString());
+    const auto bUnsaved = Package && Package->IsDirty() && !FMetaWeaverMetadataStore::IsPersistedOnWrite();
+    TMap<FName, FString> UnloadedTags;
+    for (const auto& AssetData : Assets)
+    {
+        const TMap<FName, FString>* Tags{ nullptr };
+        const auto Loaded = bUnsaved ? nullptr : AssetData.FastGetAsset(false);
+        if (AssetData.IsRedirector())
+        {
+            continue;
+        }
+        else if (Loaded)
+        {
+            Tags = FMetaWeaverMetadataStore::FindMetadataTags(Loaded);
+        }
+        else if (FMetaWeaverMetadataStore::TryReadUnloadedMetadataTags(AssetData, UnloadedTags))
+        {
+            Tags = &UnloadedTags;
+        }
+        else
+        {
+            // Saved before the metadata projection existed; indexed once it is saved again
+            bComplete = false;
+        }
+
+        if (Tags && Tags->Num() > 0)
+        {
+            Pending.Package.TagsByAsset.Add(AssetData.GetObjectPathString(), *Tags);
+        }
+    }
+
+    // An unknown version makes the next session read the package again
+    Pending.Package.Version =
+        bComplete ? FMetaWeaverMetadataStore::GetSavedMetadataVersion(PackageName, *PackageData) : 0;
+
+    Shard->Pending.Add(PackageName, MoveTemp(Pending));
+    Shard->LastChangeTime = FPlatformTime::Seconds();
+}
+
+void UMetaWeaverMetadataIndexSubsystem::BeginWrite(FShard& Shard)
+{
+    // The worker merges the mapped shard with a copy of the pending packages, so reads and queries continue meanwhile
+    auto Snapshot = Shard.Pending;
+    Shard.WritingSerials.Reset();
+    for (const auto& [PackageName, Pending] : Snapshot)
+    {
+        Shard.WritingSerials.Add(PackageName, Pending.Serial);
+    }
+
+    Shard.WriteTask = UE::Tasks::Launch(
+        UE_SOURCE_LOCATION,
+        [Mapped = Shard.Mapped, Snapshot = MoveTemp(Snapshot), Filename = GetTempFilename(Shard.Filename)]() mutable {
+            FMetaWeaverIndexedPackages Packages;
+            if (Mapped.IsValid())
+            {
+                Mapped->Decode(Packages);
+                // Let go of the mapping so the file can be replaced once this is done
+                Mapped.Reset();
+            }
+            for (auto& [PackageName, Pending] : Snapshot)
+            {
+                if (Pending.bRemoved)
+                {
+                    Packages.Remove(PackageName);
+                }
+                else
+                {
+                    Packages.Add(PackageName, MoveTemp(Pending.Package));
+                }
+            }
+            return FMetaWeaverMetadataIndexShard::Write(Filename, Packages);
+        });
+}
+
+void UMetaWeaverMetadataIndexSubsystem::FinishWrite(FShard& Shard)
+{
+    const auto bWritten = Shard.WriteTask.GetResult();
+    Shard.WriteTask = {};
+
+    auto bReplaced{ false };
+    if (bWritten)
+    {
+        // A mapped file can not be replaced on every platform, so the mapping is released first
+        Shard.Mapped.Reset();
+        bReplaced = IFileManager::Get().Move(*Shard.Filename,
+                                             *GetTempFilename(Shard.Filename),
+                                             /*bReplace*/ true,
+                                             /*bEvenIfReadOnly*/ true);
+        Shard.Mapped = FMetaWeaverMetadataIndexShard::Open(Shard.Filename);
+    }
+
+    if (bReplaced && Shard.Mapped.IsValid())
+    {
+        for (const auto& [PackageName, Serial] : Shard.WritingSerials)
+        {
+            // A package read again while the shard was written stays pending
+            if (const auto Pending = Shard.Pending.Find(PackageName); Pending && Serial == Pending->Serial)
+            {
+                Shard.Pending.Remove(PackageName);
+            }
+        }
+    }
+    else
+    {
+        UE_LOG(LogMetaWeaver, Warning, TEXT("Failed to update metadata index shard %s"), *Shard.Filename);
+        Shard.EarliestWriteTime = FPlatformTime::Seconds() + RetryDelaySeconds;
+    }
+    Shard.WritingSerials.Reset();
+}
+
+UMetaWeaverMetadataIndexSubsystem::FShard* UMetaWeaverMetadataIndexSubsystem::FindShard(const FName PackageName) const
+{
+    const auto PackageString = PackageName.ToString();
+    for (const auto& Shard : Shards)
+    {
+        if (PackageString.StartsWith(Shard->MountPoint))
+        {
+            return &Shard.Get();
+        }
+    }
+    return nullptr;
+}
+
+TArray<FSoftObjectPath> UMetaWeaverMetadataIndexSubsystem::FindAssets(const FName Key, const FString* Value) const
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_MetadataIndexQuery);
+
+    TArray<FSoftObjectPath> Assets;
+    for (const auto& Shard : Shards)
+    {
+        for (const auto& [PackageName, Pending] : Shard->Pending)
+        {
+            for (const auto& [AssetPath, Tags] : Pending.Package.TagsByAsset)
+            {
+                // ReSharper disable once CppTooWideScopeInitStatement
+                const auto Found = Tags.Find(Key);
+                if (Found && (!Value || Found->Equals(*Value, ESearchCase::CaseSensitive)))
+                {
+                    Assets.Emplace(AssetPath);
+                }
+            }
+        }
+
+        // Rows of pending packages are out of date
+        if (Shard->Mapped.IsValid())
+        {
+            Shard->Mapped->ForEachAssetWithTag(Key,
+                                               Value,
+                                               [&Assets, &Shard](const int32 PackageIndex, const FString& AssetPath) {
+                                                   if (!Shard->Pending.Contains(
+                                                           Shard->Mapped->GetPackageName(PackageIndex)))
+                                                   {
+                                                       Assets.Emplace(AssetPath);
+                                                   }
+                                               });
+        }
+    }
+    return Assets;
+}
+
+void UMetaWeaverMetadataIndexSubsystem::OnPackageSaved(const FString&, UPackage* Package, FObjectPostSaveContext)
+{
+    // Saving may add or remove assets with either storage, and persists package metadata
+    if (Package)
+    {
+        StalePackages.Add(Package->GetFName());
+    }
+}
+
+void UMetaWeaverMetadataIndexSubsystem::OnMetadataChanged(const UPackage* Package)
+{
+    // Sidecar metadata is persisted as it is written; package metadata only once it is saved
+    if (Package && FMetaWeaverMetadataStore::IsPersistedOnWrite())
+    {
+        StalePackages.Add(Package->GetFName());
+    }
+}
+
+void UMetaWeaverMetadataIndexSubsystem::OnAssetRemoved(const FAssetData& AssetData)
+{
+    StalePackages.Add(AssetData.PackageName);
+}
+
+void UMetaWeaverMetadataIndexSubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+    StalePackages.Add(FSoftObjectPath(OldObjectPath).GetLongPackageFName());
+    StalePackages.Add(AssetData.PackageName);
+}
@@ -13,64 +13,308 @@
  */
 #include "MetaWeaverMetadataStore.h"
 #include "Editor.h"
+#include "MetaWeaver/MetaWeaverPackageMetadataBackend.h"
+#include "MetaWeaver/MetaWeaverProjectSettings.h"
+#include "MetaWeaver/MetaWeaverSidecarMetadataBackend.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
 #include "MetaWeaverMetadataDefinitionSet.h"
-#include "ScopedTransaction.h"
-#include "Subsystems/EditorAssetSubsystem.h"
-#include "UObject/MetaData.h"
+#include "MetaWeaverStats.h"
+#include "Misc/TransactionObjectEvent.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
 
-bool FMetaWeaverMetadataStore::GetMetadataTag(const UObject* Asset, const FName Key, FString& OutValue)
+namespace
 {
-    if (const auto Subsystem = GEditor->GetEditorSubsystem<UEditorAssetSubsystem>())
+    // Packages whose metadata has never been written this session are implicitly at generation zero
+    TMap<FObjectKey, uint32> GenerationByPackage;
+
+    // Drops the generations of collected packages; bound on the first write
+    FDelegateHandle PostGarbageCollectHandle;
+
+    FMetaWeaverMetadataStore::FOnMetadataChanged MetadataChangedEvent;
+
+    // Chosen from the project settings on first use; changing the setting requires a restart
+    TSharedPtr<IMetaWeaverMetadataBackend> Backend;
+
+    // The tags of every asset written inside a transaction, as of the last write or undo/redo, so undo/redo can tell
+    // whether it restored the metadata of the asset or only other state
+    TMap<FObjectKey, TMap<FName, FString>> TransactedTagsByAsset;
+
+    void PruneGenerations()
     {
-        UObject* MutableAsset = const_cast<UObject*>(Asset);
-        OutValue = Subsystem->GetMetadataTag(MutableAsset, Key);
-        return !OutValue.IsEmpty();
+        // A reloaded package gets a new key, so the generation of a collected one can never be read again
+        for (auto It = GenerationByPackage.CreateIterator(); It; ++It)
+        {
+            if (!It.Key().ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
+        for (auto It = TransactedTagsByAsset.CreateIterator(); It; ++It)
+        {
+            if (!It.Key().ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
     }
-    return false;
-}
 
-bool FMetaWeaverMetadataStore::SetMetadataTag(UObject* Asset, const FName Key, const FString& Value)
-{
-    if (const auto Subsystem = GEditor->GetEditorSubsystem<UEditorAssetSubsystem>())
+    // Values are compared case-sensitively, unlike FString::operator==, so a change of case is a change
+    bool AreTagsEqual(const TMap<FName, FString>* Tags, const TMap<FName, FString>& Recorded)
     {
-        Subsystem->SetMetadataTag(Asset, Key, Value);
+        if ((Tags ? Tags->Num() : 0) != Recorded.Num())
+        {
+            return false;
+        }
+        for (const auto& [Key, Value] : Recorded)
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Current = Tags->Find(Key);
+            if (!Current || !Current->Equals(Value, ESearchCase::CaseSensitive))
+            {
+                return false;
+            }
+        }
         return true;
     }
-    return false;
+
+    void AdvanceGeneration(const UPackage* Package)
+    {
+        check(IsInGameThread());
+        if (!PostGarbageCollectHandle.IsValid())
+        {
+            PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&PruneGenerations);
+        }
+        ++GenerationByPackage.FindOrAdd(FObjectKey(Package));
+        MetadataChangedEvent.Broadcast(Package);
+    }
+} // namespace
+
+bool FMetaWeaverMetadataStore::GetMetadataTag(const UObject* Asset, const FName Key, FString& OutValue)
+{
+    const auto Tags = FindMetadataTags(Asset);
+    const auto Value = Tags ? Tags->Find(Key) : nullptr;
+    OutValue = Value ? *Value : FString();
+    return !OutValue.IsEmpty();
+}
+
+bool FMetaWeaverMetadataStore::SetMetadataTag(UObject* Asset, const FName Key, const FString& Value)
+{
+    TArray<EMetaWeaverWriteResult> Results;
+    WriteMetadataTags({ FMetaWeaverMetadataWrite::Set(Asset, Key, Value) }, Results);
+    return EMetaWeaverWriteResult::Failed != Results[0];
 }
 
 bool FMetaWeaverMetadataStore::RemoveMetadataTag(UObject* Asset, const FName Key)
 {
-    if (const auto Subsystem = GEditor->GetEditorSubsystem<UEditorAssetSubsystem>())
+    TArray<EMetaWeaverWriteResult> Results;
+    WriteMetadataTags({ FMetaWeaverMetadataWrite::Remove(Asset, Key) }, Results);
+    return EMetaWeaverWriteResult::Failed != Results[0];
+}
+
+void FMetaWeaverMetadataStore::WriteMetadataTags(const TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                                                 TArray<EMetaWeaverWriteResult>& OutResults)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_WriteMetadataTag);
+
+    OutResults.Init(EMetaWeaverWriteResult::Failed, Writes.Num());
+
+    // Like UEditorAssetSubsystem, refuse to edit metadata outside the editor or while playing in editor
+    if (GIsEditor && GEditor && !GEditor->PlayWorld)
     {
-        Subsystem->RemoveMetadataTag(Asset, Key);
-        return true;
+        TMap<UPackage*, TArray<int32, TInlineAllocator<8>>> WritesByPackage;
+        for (int32 Index = 0; Index < Writes.Num(); ++Index)
+        {
+            const auto& Write = Writes[Index];
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Package = Write.Asset ? Write.Asset->GetPackage() : nullptr;
+            if (Package && !Write.Key.IsNone())
+            {
+                WritesByPackage.FindOrAdd(Package).Add(Index);
+            }
+        }
+
+        auto& PackageBackend = GetBackend();
+        int32 NumWritten{ 0 };
+        for (const auto& [Package, Indexes] : WritesByPackage)
+        {
+            PackageBackend.WritePackage(*Package, Writes, Indexes, OutResults);
+
+            int32 NumApplied{ 0 };
+            for (const auto Index : Indexes)
+            {
+                NumApplied += EMetaWeaverWriteResult::Applied == OutResults[Index] ? 1 : 0;
+            }
+
+            // Readers compare stamps after the batch, so one advance covers every edit of the package
+            if (NumApplied > 0)
+            {
+                AdvanceGeneration(Package);
+            }
+
+            // Undo/redo of the current transaction may restore these tags later
+            for (const auto Index : Indexes)
+            {
+                if (GUndo && EMetaWeaverWriteResult::Applied == OutResults[Index])
+                {
+                    const auto Asset = Writes[Index].Asset;
+                    const auto Tags = PackageBackend.FindTags(Asset);
+                    TransactedTagsByAsset.Add(FObjectKey(Asset), Tags ? *Tags : TMap<FName, FString>());
+                }
+            }
+            NumWritten += NumApplied;
+        }
+        INC_DWORD_STAT_BY(STAT_MetaWeaver_TagsWritten, NumWritten);
     }
-    return false;
 }
 
 bool FMetaWeaverMetadataStore::ListMetadataTags(const UObject* Asset, TMap<FName, FString>& OutTags)
 {
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_ListMetadataTags);
+
+    OutTags.Reset();
+    if (const auto Tags = FindMetadataTags(Asset))
+    {
+        OutTags = *Tags;
+    }
+    return OutTags.Num() > 0;
+}
+
+bool FMetaWeaverMetadataStore::ListMetadataTags(const UObject* Asset,
+                                                const FMetaWeaverSpecTable& SpecTable,
+                                                TMap<FName, FString>& OutTags)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_ListMetadataTags);
+
     OutTags.Reset();
-    if (Asset)
+    if (const auto Tags = FindMetadataTags(Asset))
     {
-        if (const auto Package = Asset->GetOutermost())
+        // Walk whichever side is smaller; both lookups are hashed
+        if (Tags->Num() <= SpecTable.Num())
         {
-            if (const auto Map = Package->GetMetaData().GetMapForObject(Asset))
+            for (const auto& [Key, Value] : *Tags)
             {
-                OutTags = *Map;
-                return OutTags.Num() > 0;
+                if (SpecTable.Contains(Key))
+                {
+                    OutTags.Add(Key, Value);
+                }
             }
         }
+        else
+        {
+            for (const auto& Spec : SpecTable.GetSpecs())
+            {
+                if (const auto Value = Tags->Find(Spec.Key))
+                {
+                    OutTags.Add(Spec.Key, *Value);
+                }
+            }
+        }
+    }
+    return OutTags.Num() > 0;
+}
+
+const TMap<FName, FString>* FMetaWeaverMetadataStore::FindMetadataTags(const UObject* Asset)
+{
+    return Asset ? GetBackend().FindTags(Asset) : nullptr;
+}
+
+bool FMetaWeaverMetadataStore::CanReadUnloadedMetadataTags(const FAssetData& AssetData)
+{
+    return GetBackend().CanReadUnloadedTags(AssetData);
+}
+
+bool FMetaWeaverMetadataStore::TryReadUnloadedMetadataTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags)
+{
+    return GetBackend().TryReadUnloadedTags(AssetData, OutTags);
+}
+
+bool FMetaWeaverMetadataStore::IsPersistedOnWrite()
+{
+    return GetBackend().IsPersistedOnWrite();
+}
+
+uint64 FMetaWeaverMetadataStore::GetSavedMetadataVersion(const FName PackageName, const FAssetPackageData& PackageData)
+{
+    return GetBackend().GetSavedVersion(PackageName, PackageData);
+}
+
+FMetaWeaverMetadataStamp FMetaWeaverMetadataStore::GetMetadataStamp(const UObject* Asset)
+{
+    FMetaWeaverMetadataStamp Stamp;
+    if (const auto Package = Asset ? Asset->GetPackage() : nullptr)
+    {
+        Stamp.Package = FObjectKey(Package);
+        Stamp.Generation = GenerationByPackage.FindRef(Stamp.Package);
+    }
+    return Stamp;
+}
+
+void FMetaWeaverMetadataStore::OnObjectTransacted(UObject* Object, const FTransactionObjectEvent& Event)
+{
+    // Undo/redo restores the metadata without going through the store. Only assets written inside a transaction can
+    // have their metadata restored, and the transaction may only have touched other state of the asset.
+    if (Object && ETransactionObjectEventType::UndoRedo == Event.GetEventType())
+    {
+        const auto Recorded = TransactedTagsByAsset.Find(FObjectKey(Object));
+        const auto Tags = Recorded ? FindMetadataTags(Object) : nullptr;
+        if (Recorded && !AreTagsEqual(Tags, *Recorded))
+        {
+            *Recorded = Tags ? *Tags : TMap<FName, FString>();
+            AdvanceGeneration(Object->GetPackage());
+        }
     }
-    return false;
 }
 
-void FMetaWeaverMetadataStore::GatherSpecsForClass(const UClass* Class, TArray<FMetadataParameterSpec>& OutSpecs)
+void FMetaWeaverMetadataStore::NotifyMetadataChanged(const UPackage* Package)
+{
+    if (Package)
+    {
+        AdvanceGeneration(Package);
+    }
+}
+
+FMetaWeaverMetadataStore::FOnMetadataChanged& FMetaWeaverMetadataStore::OnMetadataChanged()
+{
+    return MetadataChangedEvent;
+}
+
+void FMetaWeaverMetadataStore::ReleaseBackend()
+{
+    Backend.Reset();
+
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+    PostGarbageCollectHandle.Reset();
+    GenerationByPackage.Empty();
+    TransactedTagsByAsset.Empty();
+}
+
+FMetaWeaverSpecTableRef FMetaWeaverMetadataStore::GetSpecTableForClass(const UClass* Class)
 {
     if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
     {
-        Subsystem->GatherSpecsForClass(Class, OutSpecs);
+        return Subsystem->GetSpecTableForClass(Class);
+    }
+    else
+    {
+        return FMetaWeaverSpecTable::Empty();
+    }
+}
+
+IMetaWeaverMetadataBackend& FMetaWeaverMetadataStore::GetBackend()
+{
+    check(IsInGameThread());
+
+    if (!Backend.IsValid())
+    {
+        if (EMetaWeaverMetadataStorage::Sidecar == GetDefault<UMetaWeaverProjectSettings>()->MetadataStorage)
+        {
+            Backend = MakeShared<FMetaWeaverSidecarMetadataBackend>();
+        }
+        else
+        {
+            Backend = MakeShared<FMetaWeaverPackageMetadataBackend>();
+        }
     }
+    return *Backend;
 }
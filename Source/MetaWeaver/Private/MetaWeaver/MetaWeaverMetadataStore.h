@@ -15,13 +15,60 @@
 
 #include "AssetRegistry/AssetData.h"
 #include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+#include "UObject/ObjectKey.h"
 
-struct FMetadataParameterSpec;
+class FTransactionObjectEvent;
+class IMetaWeaverMetadataBackend;
 class UObject;
+class UPackage;
 class UEditorAssetSubsystem;
 
+/** A single edit of a batch write. An unset value removes the key. */
+struct FMetaWeaverMetadataWrite
+{
+    UObject* Asset{ nullptr };
+    FName Key{ NAME_None };
+    TOptional<FString> Value;
+
+    static FMetaWeaverMetadataWrite Set(UObject* Asset, const FName Key, FString Value)
+    {
+        return { Asset, Key, MoveTemp(Value) };
+    }
+    static FMetaWeaverMetadataWrite Remove(UObject* Asset, const FName Key) { return { Asset, Key, {} }; }
+};
+
+/** The outcome of one edit of a batch write. */
+enum class EMetaWeaverWriteResult : uint8
+{
+    // The metadata was changed
+    Applied,
+    // The key already had the value, or was already absent, so nothing was changed
+    Unchanged,
+    // The asset or key was invalid, or metadata can not be edited right now (outside the editor or during PIE)
+    Failed
+};
+
+/**
+ * Identifies a version of a package's metadata. Two stamps of a package compare equal until its metadata is written
+ * through the store or restored by undo/redo, so readers can keep what they read and skip reading it again.
+ * A default stamp never equals a real one.
+ */
+struct FMetaWeaverMetadataStamp
+{
+    FObjectKey Package;
+    uint32 Generation{ 0 };
+
+    bool operator==(const FMetaWeaverMetadataStamp& Other) const
+    {
+        return Package == Other.Package && Generation == Other.Generation;
+    }
+    bool operator!=(const FMetaWeaverMetadataStamp& Other) const { return !(*this == Other); }
+};
+
 /**
- * Thin adapter over UEditorAssetSubsystem for asset metadata tags.
+ * Reads and writes the metadata of assets through the storage backend chosen in the project settings: the package's
+ * UMetaData, or a sidecar file next to the package. Callers see the same tags and stamps with either backend.
  */
 class FMetaWeaverMetadataStore final
 {
@@ -31,8 +78,73 @@ public:
     static bool SetMetadataTag(UObject* Asset, FName Key, const FString& Value);
     static bool RemoveMetadataTag(UObject* Asset, FName Key);
 
-    // Enumerate all metadata tags via UMetaData
+    /**
+     * Apply many edits across many assets. Edits are grouped by package and each package's metadata is written in one
+     * pass; with package storage each changed asset is modified once (recording it with the active transaction and
+     * dirtying its package) rather than once per key, and a sidecar is written once. Edits that would not change
+     * anything are skipped. OutResults is parallel to Writes.
+     */
+    static void WriteMetadataTags(TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                                  TArray<EMetaWeaverWriteResult>& OutResults);
+
+    // Enumerate all metadata tags of a loaded asset
     static bool ListMetadataTags(const UObject* Asset, TMap<FName, FString>& OutTags);
 
-    static void GatherSpecsForClass(const UClass* Class, TArray<FMetadataParameterSpec>& OutSpecs);
+    /**
+     * Copy only the tags for keys the spec table defines. Engine and ad-hoc keys are skipped, so a snapshot for
+     * validation costs no more than the specs that will read it.
+     */
+    static bool ListMetadataTags(const UObject* Asset,
+                                 const FMetaWeaverSpecTable& SpecTable,
+                                 TMap<FName, FString>& OutTags);
+
+    /**
+     * Return the asset's metadata tags in place, or null if it has none. Nothing is copied. The view is owned by the
+     * backend and is only valid until the package's metadata is next modified, so read it immediately. Game thread
+     * only.
+     */
+    static const TMap<FName, FString>* FindMetadataTags(const UObject* Asset);
+
+    /** Return true if the metadata of the asset can be read without loading it. */
+    static bool CanReadUnloadedMetadataTags(const FAssetData& AssetData);
+
+    /**
+     * Copy the metadata of an asset that need not be loaded: the tags projected into the asset registry when its
+     * package was saved, or its sidecar. Returns false if the asset would have to be loaded. Game thread only.
+     */
+    static bool TryReadUnloadedMetadataTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags);
+
+    /** Return true if writes are persisted at once rather than when the asset's package is next saved. */
+    static bool IsPersistedOnWrite();
+
+    /**
+     * Return a hash of the persisted state of the package's metadata: its saved hash in the asset registry, and with
+     * sidecar storage the time the sidecar was written. A different hash means the metadata may have changed.
+     */
+    static uint64 GetSavedMetadataVersion(FName PackageName, const FAssetPackageData& PackageData);
+
+    /**
+     * Return the current stamp of the metadata of the asset's package. A reloaded package gets a new identity, so its
+     * stamps differ from those of the package it replaced. Writes that bypass the store are not seen. Game thread only.
+     */
+    static FMetaWeaverMetadataStamp GetMetadataStamp(const UObject* Asset);
+
+    // Advance the stamp of the package of an asset whose metadata undo/redo restored. Bound by the module.
+    static void OnObjectTransacted(UObject* Object, const FTransactionObjectEvent& Event);
+
+    // Advance the stamp of a package whose metadata the backend changed outside a write, such as on undo/redo
+    static void NotifyMetadataChanged(const UPackage* Package);
+
+    /** Event fired on the game thread after the metadata of a package changed, once per package per write. */
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnMetadataChanged, const UPackage*);
+    static FOnMetadataChanged& OnMetadataChanged();
+
+    // Release the storage backend and the delegates bound by it and the store. Called by the module on shutdown.
+    static void ReleaseBackend();
+
+    // Shared spec table for the class; an empty table if the validation subsystem is unavailable
+    static FMetaWeaverSpecTableRef GetSpecTableForClass(const UClass* Class);
+
+private:
+    static IMetaWeaverMetadataBackend& GetBackend();
 };
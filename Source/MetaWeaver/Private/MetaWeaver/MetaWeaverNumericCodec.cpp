@@ -0,0 +1,240 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverNumericCodec.h"
+#include "Misc/StringBuilder.h"
+
+namespace
+{
+    constexpr bool IsDigit(const TCHAR Character)
+    {
+        return Character >= TEXT('0') && Character <= TEXT('9');
+    }
+
+    // Count the digits starting at Index, advancing Index past them
+    int32 SkipDigits(const FStringView In, int32& Index)
+    {
+        const auto Start = Index;
+        while (Index < In.Len() && IsDigit(In[Index]))
+        {
+            ++Index;
+        }
+        return Index - Start;
+    }
+
+    /** Match -?digits(.digits?)?([eE][+-]?digits)? or -?.digits(...)? against the whole string. */
+    bool IsFloatSyntax(const FStringView In)
+    {
+        int32 Index{ 0 };
+        if (Index < In.Len() && TEXT('-') == In[Index])
+        {
+            ++Index;
+        }
+
+        auto NumMantissaDigits = SkipDigits(In, Index);
+        if (Index < In.Len() && TEXT('.') == In[Index])
+        {
+            ++Index;
+            NumMantissaDigits += SkipDigits(In, Index);
+        }
+        if (0 == NumMantissaDigits)
+        {
+            return false;
+        }
+
+        if (Index < In.Len() && (TEXT('e') == In[Index] || TEXT('E') == In[Index]))
+        {
+            ++Index;
+            if (Index < In.Len() && (TEXT('+') == In[Index] || TEXT('-') == In[Index]))
+            {
+                ++Index;
+            }
+            if (0 == SkipDigits(In, Index))
+            {
+                return false;
+            }
+        }
+        return Index == In.Len();
+    }
+
+    /**
+     * Render scientific output of the form "-d.ddde+XX" in positional notation when the decimal exponent is within
+     * [-7, 21), as JavaScript does, otherwise as the minimal scientific form "-d.ddde+X".
+     */
+    FString ToCanonicalNotation(const FString& Scientific)
+    {
+        int32 ExponentIndex{ INDEX_NONE };
+        verify(Scientific.FindChar(TEXT('e'), ExponentIndex));
+
+        const bool bNegative = Scientific.StartsWith(TEXT("-"));
+        FString Digits;
+        for (int32 Index = bNegative ? 1 : 0; Index < ExponentIndex; ++Index)
+        {
+            if (TEXT('.') != Scientific[Index])
+            {
+                Digits.AppendChar(Scientific[Index]);
+            }
+        }
+        while (Digits.Len() > 1 && Digits.EndsWith(TEXT("0")))
+        {
+            Digits.LeftChopInline(1);
+        }
+        const auto Exponent = FCString::Atoi(*Scientific + ExponentIndex + 1);
+
+        // Position of the decimal point relative to the start of the digits
+        const auto Point = Exponent + 1;
+        const auto NumDigits = Digits.Len();
+
+        TStringBuilder<64> Out;
+        if (bNegative)
+        {
+            Out << TEXT('-');
+        }
+        if (NumDigits <= Point && Point <= 21)
+        {
+            Out << Digits;
+            for (int32 Index = NumDigits; Index < Point; ++Index)
+            {
+                Out << TEXT('0');
+            }
+        }
+        else if (0 < Point && Point <= 21)
+        {
+            Out << Digits.Left(Point) << TEXT('.') << Digits.RightChop(Point);
+        }
+        else if (-6 < Point && Point <= 0)
+        {
+            Out << TEXT("0.");
+            for (int32 Index = Point; Index < 0; ++Index)
+            {
+                Out << TEXT('0');
+            }
+            Out << Digits;
+        }
+        else
+        {
+            Out << Digits[0];
+            if (NumDigits > 1)
+            {
+                Out << TEXT('.') << Digits.RightChop(1);
+            }
+            Out << TEXT('e') << (Exponent < 0 ? TEXT('-') : TEXT('+')) << FMath::Abs(Exponent);
+        }
+        return FString(Out.ToView());
+    }
+} // namespace
+
+FString FMetaWeaverNumericCodec::FormatInteger(const int64 Value)
+{
+    return LexToString(Value);
+}
+
+FString FMetaWeaverNumericCodec::FormatFloat(const double Value)
+{
+    if (!FMath::IsFinite(Value))
+    {
+        // Not representable in metadata; parsing rejects these so they never become canonical values
+        return LexToString(Value);
+    }
+    else if (0.0 == Value)
+    {
+        // Also folds -0 into 0 so that equal values compare byte-equal
+        return TEXT("0");
+    }
+    else
+    {
+        // 17 significant digits always round-trip a double, so the search terminates
+        for (int32 Precision = 1; Precision < 17; ++Precision)
+        {
+            const auto Candidate = FString::Printf(TEXT("%.*e"), Precision - 1, Value);
+            // ReSharper disable once CppTooWideScopeInitStatement
+            double Parsed{ 0.0 };
+            if (TryParseFloat(Candidate, Parsed) && Parsed == Value)
+            {
+                return ToCanonicalNotation(Candidate);
+            }
+        }
+        return ToCanonicalNotation(FString::Printf(TEXT("%.16e"), Value));
+    }
+}
+
+bool FMetaWeaverNumericCodec::TryParseInteger(const FStringView In, int64& Out)
+{
+    int32 Index{ 0 };
+    const bool bNegative = In.Len() > 0 && TEXT('-') == In[0];
+    if (bNegative)
+    {
+        ++Index;
+    }
+    if (Index == In.Len())
+    {
+        return false;
+    }
+
+    // Accumulate as a negative number so that the magnitude of MIN_int64 does not overflow
+    int64 Value{ 0 };
+    for (; Index < In.Len(); ++Index)
+    {
+        const auto Character = In[Index];
+        if (!IsDigit(Character))
+        {
+            return false;
+        }
+        const auto Digit = static_cast<int64>(Character - TEXT('0'));
+        if (Value < (MIN_int64 + Digit) / 10)
+        {
+            return false;
+        }
+        Value = Value * 10 - Digit;
+    }
+
+    if (bNegative)
+    {
+        Out = Value;
+        return true;
+    }
+    else if (MIN_int64 == Value)
+    {
+        return false;
+    }
+    else
+    {
+        Out = -Value;
+        return true;
+    }
+}
+
+bool FMetaWeaverNumericCodec::TryParseFloat(const FStringView In, double& Out)
+{
+    if (!IsFloatSyntax(In))
+    {
+        return false;
+    }
+    else
+    {
+        // The grammar has been checked above, so the CRT conversion only ever sees a plain decimal literal.
+        // The inline buffer keeps values of typical length off the heap.
+        TStringBuilder<64> Terminated;
+        Terminated.Append(In);
+        const auto Value = FCString::Atod(Terminated.ToString());
+        if (FMath::IsFinite(Value))
+        {
+            Out = Value;
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+}
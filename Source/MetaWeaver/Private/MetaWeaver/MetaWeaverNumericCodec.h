@@ -0,0 +1,37 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Canonical text form of Integer and Float metadata values.
+ *
+ * Floats are formatted as the shortest string that parses back to exactly the same double, in positional notation
+ * unless the exponent is very large or small, so equal values always produce byte-equal strings and repeated bulk
+ * edits do not drift. Parsing follows std::from_chars: the whole string must match the grammar, there is no leading
+ * '+' or whitespace, no hex, infinity or NaN, and the decimal separator is always '.' regardless of locale.
+ */
+class FMetaWeaverNumericCodec final
+{
+public:
+    static FString FormatInteger(int64 Value);
+    static FString FormatFloat(double Value);
+
+    /** Parse a whole string as a signed 64-bit integer. Fails on overflow. Never allocates. */
+    static bool TryParseInteger(FStringView In, int64& Out);
+
+    /** Parse a whole string as a finite double. Never allocates for strings of typical length. */
+    static bool TryParseFloat(FStringView In, double& Out);
+};
@@ -0,0 +1,88 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverPackageMetadataBackend.h"
+#include "AssetRegistry/AssetData.h"
+#include "Hash/xxhash.h"
+#include "MetaWeaver/MetaWeaverTagProjection.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+
+const TMap<FName, FString>* FMetaWeaverPackageMetadataBackend::FindTags(const UObject* Asset)
+{
+    if (const auto Package = Asset ? Asset->GetOutermost() : nullptr)
+    {
+        return Package->GetMetaData().GetMapForObject(Asset);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+bool FMetaWeaverPackageMetadataBackend::CanReadUnloadedTags(const FAssetData& AssetData)
+{
+    return MetaWeaver::TagProjection::HasProjectedTags(AssetData);
+}
+
+bool FMetaWeaverPackageMetadataBackend::TryReadUnloadedTags(const FAssetData& AssetData,
+                                                            TMap<FName, FString>& OutTags)
+{
+    return MetaWeaver::TagProjection::TryGetProjectedTags(AssetData, OutTags);
+}
+
+void FMetaWeaverPackageMetadataBackend::WritePackage(UPackage& Package,
+                                                     const TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                                                     const TConstArrayView<int32> Indexes,
+                                                     const TArrayView<EMetaWeaverWriteResult> OutResults)
+{
+    auto& MetaData = Package.GetMetaData();
+    TArray<const UObject*, TInlineAllocator<4>> ModifiedAssets;
+    for (const auto Index : Indexes)
+    {
+        const auto& Write = Writes[Index];
+        const auto Tags = MetaData.GetMapForObject(Write.Asset);
+        const auto Existing = Tags ? Tags->Find(Write.Key) : nullptr;
+        const bool bUnchanged = Write.Value.IsSet()
+            ? Existing && Existing->Equals(Write.Value.GetValue(), ESearchCase::CaseSensitive)
+            : !Existing;
+        if (bUnchanged)
+        {
+            OutResults[Index] = EMetaWeaverWriteResult::Unchanged;
+        }
+        else
+        {
+            // Record the asset with the transaction before its first edit only; this also dirties the package
+            if (!ModifiedAssets.Contains(Write.Asset))
+            {
+                Write.Asset->Modify();
+                ModifiedAssets.Add(Write.Asset);
+            }
+            if (Write.Value.IsSet())
+            {
+                MetaData.SetValue(Write.Asset, Write.Key, *Write.Value.GetValue());
+            }
+            else
+            {
+                MetaData.RemoveValue(Write.Asset, Write.Key);
+            }
+            OutResults[Index] = EMetaWeaverWriteResult::Applied;
+        }
+    }
+}
+
+uint64 FMetaWeaverPackageMetadataBackend::GetSavedVersion(const FName, const FAssetPackageData& PackageData)
+{
+    const auto SavedHash = PackageData.GetPackageSavedHash();
+    return FXxHash64::HashBuffer(&SavedHash, sizeof(SavedHash)).Hash;
+}
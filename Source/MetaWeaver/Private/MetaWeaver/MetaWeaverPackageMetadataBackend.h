@@ -0,0 +1,35 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverMetadataBackend.h"
+
+/**
+ * Keeps metadata in the package of the asset, alongside the engine's own metadata. Edits dirty the package, so they
+ * are persisted when it is saved. Unloaded assets are read from the tags projected into the asset registry on save.
+ */
+class FMetaWeaverPackageMetadataBackend final : public IMetaWeaverMetadataBackend
+{
+public:
+    virtual const TMap<FName, FString>* FindTags(const UObject* Asset) override;
+    virtual bool CanReadUnloadedTags(const FAssetData& AssetData) override;
+    virtual bool TryReadUnloadedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags) override;
+    virtual void WritePackage(UPackage& Package,
+                              TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                              TConstArrayView<int32> Indexes,
+                              TArrayView<EMetaWeaverWriteResult> OutResults) override;
+    virtual bool IsPersistedOnWrite() const override { return false; }
+    virtual uint64 GetSavedVersion(FName PackageName, const FAssetPackageData& PackageData) override;
+};
@@ -18,6 +18,16 @@
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
 #include "MetaWeaverProjectSettings.generated.h"
 
+/** Where asset metadata is stored. */
+UENUM()
+enum class EMetaWeaverMetadataStorage : uint8
+{
+    /** In the asset's package; an edit dirties the package, which must then be resaved. */
+    Package,
+    /** In a .mwmeta text file next to the asset's package; an edit rewrites only that small file. */
+    Sidecar
+};
+
 /**
  * Project-wide MetaWeaver settings used by the validation subsystem.
  */
@@ -33,4 +43,11 @@ public:
               Category = "Validation",
               meta = (DisplayThumbnail = "false", ForceShowPluginContent = "true"))
     TArray<TSoftObjectPtr<UMetaWeaverMetadataDefinitionSet>> ActiveDefinitionSets;
+
+    /**
+     * Where asset metadata is read from and written to. Existing metadata is not migrated when this changes.
+     * Sidecar files keep metadata edits out of large packages and merge cleanly in source control.
+     */
+    UPROPERTY(EditDefaultsOnly, Config, Category = "Storage", meta = (ConfigRestartRequired = "true"))
+    EMetaWeaverMetadataStorage MetadataStorage{ EMetaWeaverMetadataStorage::Package };
 };
@@ -0,0 +1,536 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverSidecarMetadataBackend.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "DirectoryWatcherModule.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+#include "IDirectoryWatcher.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverTagProjection.h"
+#include "Misc/Change.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ITransaction.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "SourceControlHelpers.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+
+namespace
+{
+    const FString SidecarExtension(TEXT(".mwmeta"));
+
+    /** Swaps the tags of assets of a package with those recorded when the change was made. */
+    class FSidecarChange final : public FSwapChange
+    {
+    public:
+        FSidecarChange(TWeakPtr<FMetaWeaverSidecarMetadataBackend> InBackend,
+                       const FName InPackageName,
+                       FMetaWeaverSidecarMetadataBackend::FTagsByAsset&& InTags)
+            : Backend(MoveTemp(InBackend))
+            , PackageName(InPackageName)
+            , Tags(MoveTemp(InTags))
+        {
+        }
+
+        virtual TUniquePtr<FChange> Execute(UObject* Object) override
+        {
+            FMetaWeaverSidecarMetadataBackend::FTagsByAsset Replaced;
+            if (const auto Pinned = Backend.Pin())
+            {
+                Pinned->ReplaceTags(PackageName, Tags, Replaced);
+            }
+            if (Object)
+            {
+                FMetaWeaverMetadataStore::NotifyMetadataChanged(Object->GetPackage());
+            }
+            return MakeUnique<FSidecarChange>(Backend, PackageName, MoveTemp(Replaced));
+        }
+
+        virtual FString ToString() const override
+        {
+            return FString::Printf(TEXT("MetaWeaver sidecar change of %s"), *PackageName.ToString());
+        }
+
+    private:
+        TWeakPtr<FMetaWeaverSidecarMetadataBackend> Backend;
+        FName PackageName;
+        FMetaWeaverSidecarMetadataBackend::FTagsByAsset Tags;
+    };
+
+    FString SerializeSidecar(const FMetaWeaverSidecarMetadataBackend::FTagsByAsset& Sidecar)
+    {
+        // Sorted assets and keys keep the file stable, so unrelated edits touch different lines and merge cleanly
+        TArray<FName> AssetNames;
+        Sidecar.GenerateKeyArray(AssetNames);
+        AssetNames.Sort(FNameLexicalLess());
+
+        const auto Root = MakeShared<FJsonObject>();
+        for (const auto AssetName : AssetNames)
+        {
+            const auto& Tags = Sidecar.FindChecked(AssetName);
+            TArray<FName> Keys;
+            Tags.GenerateKeyArray(Keys);
+            Keys.Sort(FNameLexicalLess());
+
+            const auto Object = MakeShared<FJsonObject>();
+            for (const auto Key : Keys)
+            {
+                Object->SetStringField(Key.ToString(), Tags.FindChecked(Key));
+            }
+            Root->SetObjectField(AssetName.ToString(), Object);
+        }
+
+        FString Text;
+        FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Text));
+        Text += TEXT("\n");
+        return Text;
+    }
+
+    // Whether the package still holds metadata from before the switch to sidecars, which is read without a sidecar
+    bool HasPackageMetadata(const FName PackageName)
+    {
+        auto bFound{ false };
+        if (const auto Package = FindPackage(nullptr, *PackageName.ToString()))
+        {
+            ForEachObjectWithPackage(
+                Package,
+                [Package, &bFound](UObject* Object) {
+                    const auto Tags = Object->IsAsset() ? Package->GetMetaData().GetMapForObject(Object) : nullptr;
+                    bFound = Tags && Tags->Num() > 0;
+                    return !bFound;
+                },
+                /*bIncludeNestedObjects*/ false);
+        }
+        else
+        {
+            TArray<FAssetData> Assets;
+            IAssetRegistry::GetChecked().GetAssetsByPackageName(PackageName, Assets, /*bIncludeOnlyOnDiskAssets*/ true);
+            TMap<FName, FString> Tags;
+            bFound = Assets.ContainsByPredicate([&Tags](const FAssetData& AssetData) {
+                return MetaWeaver::TagProjection::TryGetProjectedTags(AssetData, Tags) && Tags.Num() > 0;
+            });
+        }
+        return bFound;
+    }
+
+    void DeserializeSidecar(const FString& Filename,
+                            const FString& Text,
+                            FMetaWeaverSidecarMetadataBackend::FTagsByAsset& OutSidecar)
+    {
+        TSharedPtr<FJsonObject> Root;
+        if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) && Root)
+        {
+            for (const auto& [AssetName, AssetValue] : Root->Values)
+            {
+                const TSharedPtr<FJsonObject>* Object{ nullptr };
+                if (AssetValue.IsValid() && AssetValue->TryGetObject(Object))
+                {
+                    auto& Tags = OutSidecar.Add(FName(AssetName));
+                    for (const auto& [Key, Value] : (*Object)->Values)
+                    {
+                        if (FString String; Value.IsValid() && Value->TryGetString(String))
+                        {
+                            Tags.Add(FName(Key), MoveTemp(String));
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            UE_LOG(LogMetaWeaver, Warning, TEXT("Metadata sidecar %s is not valid JSON; ignoring it"), *Filename);
+        }
+    }
+} // namespace
+
+FMetaWeaverSidecarMetadataBackend::FMetaWeaverSidecarMetadataBackend()
+{
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    AssetRenamedHandle =
+        AssetRegistry.OnAssetRenamed().AddRaw(this, &FMetaWeaverSidecarMetadataBackend::OnAssetRenamed);
+    AssetRemovedHandle =
+        AssetRegistry.OnAssetRemoved().AddRaw(this, &FMetaWeaverSidecarMetadataBackend::OnAssetRemoved);
+
+    // Commandlets read each sidecar once, so only the editor needs to notice files changing under it
+    if (!IsRunningCommandlet())
+    {
+        auto& Module = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+        if (const auto DirectoryWatcher = Module.Get())
+        {
+            WatchedDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir());
+            DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+                WatchedDirectory,
+                IDirectoryWatcher::FDirectoryChanged::CreateRaw(this,
+                                                                &FMetaWeaverSidecarMetadataBackend::OnDirectoryChanged),
+                DirectoryChangedHandle);
+        }
+    }
+}
+
+FMetaWeaverSidecarMetadataBackend::~FMetaWeaverSidecarMetadataBackend()
+{
+    if (const auto AssetRegistry = IAssetRegistry::Get())
+    {
+        AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+        AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+    }
+    if (DirectoryChangedHandle.IsValid())
+    {
+        if (const auto Module = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+        {
+            if (const auto DirectoryWatcher = Module->Get())
+            {
+                DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(WatchedDirectory, DirectoryChangedHandle);
+            }
+        }
+    }
+}
+
+const TMap<FName, FString>* FMetaWeaverSidecarMetadataBackend::FindTags(const UObject* Asset)
+{
+    if (const auto Package = Asset ? Asset->GetPackage() : nullptr)
+    {
+        return IsMigrated(Package->GetFName()) ? GetSidecar(Package->GetFName()).Find(Asset->GetFName())
+                                               : Package->GetMetaData().GetMapForObject(Asset);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+bool FMetaWeaverSidecarMetadataBackend::CanReadUnloadedTags(const FAssetData& AssetData)
+{
+    return IsMigrated(AssetData.PackageName) || MetaWeaver::TagProjection::HasProjectedTags(AssetData);
+}
+
+bool FMetaWeaverSidecarMetadataBackend::TryReadUnloadedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags)
+{
+    if (IsMigrated(AssetData.PackageName))
+    {
+        // A missing entry is not unknown metadata but no metadata, so reading never fails
+        const auto Tags = GetSidecar(AssetData.PackageName).Find(AssetData.AssetName);
+        OutTags = Tags ? *Tags : TMap<FName, FString>();
+        return true;
+    }
+    else
+    {
+        return MetaWeaver::TagProjection::TryGetProjectedTags(AssetData, OutTags);
+    }
+}
+
+void FMetaWeaverSidecarMetadataBackend::WritePackage(UPackage& Package,
+                                                     const TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                                                     const TConstArrayView<int32> Indexes,
+                                                     const TArrayView<EMetaWeaverWriteResult> OutResults)
+{
+    const auto PackageName = Package.GetFName();
+    auto& Sidecar = GetSidecar(PackageName);
+
+    // The first edit of a package without a sidecar moves the metadata of all its assets into one. The move itself is
+    // not undone: undo restores the edited assets to the metadata they had in the package.
+    const auto bMigrating = !IsMigrated(PackageName);
+    if (bMigrating)
+    {
+        ForEachObjectWithPackage(
+            &Package,
+            [&Package, &Sidecar](UObject* Object) {
+                const auto Tags = Object->IsAsset() ? Package.GetMetaData().GetMapForObject(Object) : nullptr;
+                if (Tags && Tags->Num() > 0)
+                {
+                    Sidecar.Add(Object->GetFName(), *Tags);
+                }
+                return true;
+            },
+            /*bIncludeNestedObjects*/ false);
+    }
+
+    // The tags of each changed asset before its first edit, to revert to on undo or if the sidecar can not be saved
+    FTagsByAsset Previous;
+    UObject* FirstChanged{ nullptr };
+    for (const auto Index : Indexes)
+    {
+        const auto& Write = Writes[Index];
+        const auto AssetName = Write.Asset->GetFName();
+        const auto Tags = Sidecar.Find(AssetName);
+        const auto Existing = Tags ? Tags->Find(Write.Key) : nullptr;
+        const bool bUnchanged = Write.Value.IsSet()
+            ? Existing && Existing->Equals(Write.Value.GetValue(), ESearchCase::CaseSensitive)
+            : !Existing;
+        if (bUnchanged)
+        {
+            OutResults[Index] = EMetaWeaverWriteResult::Unchanged;
+        }
+        else
+        {
+            if (!Previous.Contains(AssetName))
+            {
+                Previous.Add(AssetName, Tags ? *Tags : TMap<FName, FString>());
+            }
+            if (Write.Value.IsSet())
+            {
+                Sidecar.FindOrAdd(AssetName).Add(Write.Key, Write.Value.GetValue());
+            }
+            else
+            {
+                Tags->Remove(Write.Key);
+                if (0 == Tags->Num())
+                {
+                    Sidecar.Remove(AssetName);
+                }
+            }
+            FirstChanged = FirstChanged ? FirstChanged : Write.Asset;
+            OutResults[Index] = EMetaWeaverWriteResult::Applied;
+        }
+    }
+
+    if (!FirstChanged && bMigrating)
+    {
+        // Nothing to write, so the package keeps reading its own metadata
+        Sidecar.Reset();
+    }
+    else if (FirstChanged)
+    {
+        if (SaveSidecar(PackageName))
+        {
+            // The change is recorded against the first edited asset, which the transaction keeps alive
+            if (GUndo)
+            {
+                GUndo->StoreUndo(FirstChanged, MakeUnique<FSidecarChange>(AsWeak(), PackageName, MoveTemp(Previous)));
+            }
+        }
+        else
+        {
+            // Keep memory in line with the file on disk
+            if (bMigrating)
+            {
+                Sidecar.Reset();
+                Previous.Reset();
+            }
+            for (const auto& [AssetName, Tags] : Previous)
+            {
+                if (Tags.Num() > 0)
+                {
+                    Sidecar.Add(AssetName, Tags);
+                }
+                else
+                {
+                    Sidecar.Remove(AssetName);
+                }
+            }
+            for (const auto Index : Indexes)
+            {
+                if (EMetaWeaverWriteResult::Applied == OutResults[Index])
+                {
+                    OutResults[Index] = EMetaWeaverWriteResult::Failed;
+                }
+            }
+        }
+    }
+}
+
+uint64 FMetaWeaverSidecarMetadataBackend::GetSavedVersion(const FName PackageName, const FAssetPackageData& PackageData)
+{
+    // The package decides which assets exist, the sidecar what they hold
+    const auto SavedHash = PackageData.GetPackageSavedHash();
+    const auto TimeStamp = IFileManager::Get().GetTimeStamp(*GetSidecarFilename(PackageName)).GetTicks();
+    FXxHash64Builder Builder;
+    Builder.Update(&SavedHash, sizeof(SavedHash));
+    Builder.Update(&TimeStamp, sizeof(TimeStamp));
+    return Builder.Finalize().Hash;
+}
+
+bool FMetaWeaverSidecarMetadataBackend::ReplaceTags(const FName PackageName,
+                                                    const FTagsByAsset& Tags,
+                                                    FTagsByAsset& OutReplaced)
+{
+    auto& Sidecar = GetSidecar(PackageName);
+    OutReplaced.Reset();
+    for (const auto& [AssetName, AssetTags] : Tags)
+    {
+        TMap<FName, FString> Replaced;
+        Sidecar.RemoveAndCopyValue(AssetName, Replaced);
+        OutReplaced.Add(AssetName, MoveTemp(Replaced));
+        if (AssetTags.Num() > 0)
+        {
+            Sidecar.Add(AssetName, AssetTags);
+        }
+    }
+    return SaveSidecar(PackageName);
+}
+
+FString FMetaWeaverSidecarMetadataBackend::GetSidecarFilename(const FName PackageName)
+{
+    return FPaths::ConvertRelativePathToFull(
+        FPackageName::LongPackageNameToFilename(PackageName.ToString(), SidecarExtension));
+}
+
+FMetaWeaverSidecarMetadataBackend::FTagsByAsset& FMetaWeaverSidecarMetadataBackend::GetSidecar(const FName PackageName)
+{
+    check(IsInGameThread());
+
+    if (const auto Found = SidecarsByPackage.Find(PackageName))
+    {
+        return *Found;
+    }
+    else
+    {
+        auto& Sidecar = SidecarsByPackage.Add(PackageName);
+        const auto Filename = GetSidecarFilename(PackageName);
+        FString Text;
+        if (FFileHelper::LoadFileToString(Text, *Filename, FFileHelper::EHashOptions::None, FILEREAD_Silent))
+        {
+            UnmigratedPackages.Remove(PackageName);
+            DeserializeSidecar(Filename, Text, Sidecar);
+        }
+        else
+        {
+            UnmigratedPackages.Add(PackageName);
+        }
+        return Sidecar;
+    }
+}
+
+bool FMetaWeaverSidecarMetadataBackend::IsMigrated(const FName PackageName)
+{
+    GetSidecar(PackageName);
+    return !UnmigratedPackages.Contains(PackageName);
+}
+
+bool FMetaWeaverSidecarMetadataBackend::SaveSidecar(const FName PackageName)
+{
+    const auto& Sidecar = SidecarsByPackage.FindChecked(PackageName);
+    const auto Filename = GetSidecarFilename(PackageName);
+    const bool bExists = FPaths::FileExists(Filename);
+    const bool bUseSourceControl = USourceControlHelpers::IsAvailable();
+
+    // An empty sidecar is deleted rather than left behind, unless the package still holds metadata from before the
+    // switch to sidecars that would be read again without it
+    auto bSaved{ true };
+    if (0 == Sidecar.Num()
+        && !(FPackageName::DoesPackageExist(PackageName.ToString()) && HasPackageMetadata(PackageName)))
+    {
+        if (bExists)
+        {
+            bSaved = bUseSourceControl ? USourceControlHelpers::MarkFileForDelete(Filename, /*bSilent*/ true)
+                                       : IFileManager::Get().Delete(*Filename);
+        }
+        if (bSaved)
+        {
+            UnmigratedPackages.Add(PackageName);
+            WrittenSidecarHashes.Add(PackageName, TOptional<uint64>());
+        }
+    }
+    else
+    {
+        if (bExists && bUseSourceControl)
+        {
+            USourceControlHelpers::CheckOutFile(Filename, /*bSilent*/ true);
+        }
+        // Written as UTF-8 without a BOM, hashed exactly as written
+        const FTCHARToUTF8 Contents(*SerializeSidecar(Sidecar));
+        const TArrayView64<const uint8> Bytes(reinterpret_cast<const uint8*>(Contents.Get()), Contents.Length());
+        bSaved = FFileHelper::SaveArrayToFile(Bytes, *Filename);
+        if (bSaved && !bExists && bUseSourceControl)
+        {
+            USourceControlHelpers::MarkFileForAdd(Filename, /*bSilent*/ true);
+        }
+        if (bSaved)
+        {
+            UnmigratedPackages.Remove(PackageName);
+            WrittenSidecarHashes.Add(PackageName, FXxHash64::HashBuffer(Bytes.GetData(), Bytes.Num()).Hash);
+        }
+    }
+
+    if (!bSaved)
+    {
+        UE_LOG(LogMetaWeaver, Warning, TEXT("Failed to write metadata sidecar %s"), *Filename);
+    }
+    return bSaved;
+}
+
+bool FMetaWeaverSidecarMetadataBackend::IsOwnWrite(const FName PackageName) const
+{
+    const auto Written = WrittenSidecarHashes.Find(PackageName);
+    if (!Written)
+    {
+        return false;
+    }
+
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *GetSidecarFilename(PackageName), FILEREAD_Silent))
+    {
+        return !Written->IsSet();
+    }
+    return Written->IsSet() && Written->GetValue() == FXxHash64::HashBuffer(Bytes.GetData(), Bytes.Num()).Hash;
+}
+
+void FMetaWeaverSidecarMetadataBackend::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+    // The metadata moves with the asset, possibly to the sidecar of another package
+    const FSoftObjectPath OldPath(OldObjectPath);
+    const auto OldPackageName = OldPath.GetLongPackageFName();
+    TMap<FName, FString> Tags;
+    if (GetSidecar(OldPackageName).RemoveAndCopyValue(OldPath.GetAssetFName(), Tags))
+    {
+        SaveSidecar(OldPackageName);
+        GetSidecar(AssetData.PackageName).Add(AssetData.AssetName, MoveTemp(Tags));
+        SaveSidecar(AssetData.PackageName);
+    }
+}
+
+void FMetaWeaverSidecarMetadataBackend::OnAssetRemoved(const FAssetData& AssetData)
+{
+    // Only drop the entry once the package is gone for good, not when it is merely unregistered
+    if (!FPackageName::DoesPackageExist(AssetData.PackageName.ToString())
+        && GetSidecar(AssetData.PackageName).Remove(AssetData.AssetName) > 0)
+    {
+        SaveSidecar(AssetData.PackageName);
+    }
+}
+
+void FMetaWeaverSidecarMetadataBackend::OnDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+    for (const auto& Change : Changes)
+    {
+        FString PackageName;
+        if (Change.Filename.EndsWith(SidecarExtension)
+            && FPackageName::TryConvertFilenameToLongPackageName(FPaths::ChangeExtension(Change.Filename, FString()),
+                                                                  PackageName))
+        {
+            // Reread on next use. Our own writes land here too, and the sidecar in memory already matches them.
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const FName Name(PackageName);
+            if (!IsOwnWrite(Name))
+            {
+                WrittenSidecarHashes.Remove(Name);
+                UnmigratedPackages.Remove(Name);
+                if (SidecarsByPackage.Remove(Name) > 0)
+                {
+                    if (const auto Package = FindPackage(nullptr, *PackageName))
+                    {
+                        FMetaWeaverMetadataStore::NotifyMetadataChanged(Package);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverMetadataBackend.h"
+
+struct FFileChangeData;
+
+/**
+ * Keeps metadata in a small text file next to each package (Content/Maps/Arena.umap -> Content/Maps/Arena.mwmeta),
+ * so tagging an asset never dirties or resaves its package. Each edit rewrites only the sidecar of the package, which
+ * is checked out or added in source control first. The files are JSON with one key per line in sorted order, so
+ * concurrent edits merge cleanly, and they are read without loading the asset.
+ *
+ * Undo and redo are recorded with the active transaction. Renaming or deleting an asset moves or drops its entry.
+ * Sidecars changed on disk by another process (e.g. a sync) are reread on next use.
+ *
+ * A package without a sidecar is read as the package backend reads it, so metadata stored before switching to
+ * sidecars stays visible. The first edit of such a package moves the metadata of all its assets into the sidecar.
+ */
+class FMetaWeaverSidecarMetadataBackend final : public IMetaWeaverMetadataBackend,
+                                                public TSharedFromThis<FMetaWeaverSidecarMetadataBackend>
+{
+public:
+    // Tags of each asset of a package, keyed by asset name
+    using FTagsByAsset = TMap<FName, TMap<FName, FString>>;
+
+    FMetaWeaverSidecarMetadataBackend();
+    virtual ~FMetaWeaverSidecarMetadataBackend() override;
+
+    virtual const TMap<FName, FString>* FindTags(const UObject* Asset) override;
+    virtual bool CanReadUnloadedTags(const FAssetData& AssetData) override;
+    virtual bool TryReadUnloadedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags) override;
+    virtual void WritePackage(UPackage& Package,
+                              TConstArrayView<FMetaWeaverMetadataWrite> Writes,
+                              TConstArrayView<int32> Indexes,
+                              TArrayView<EMetaWeaverWriteResult> OutResults) override;
+    virtual bool IsPersistedOnWrite() const override { return true; }
+    virtual uint64 GetSavedVersion(FName PackageName, const FAssetPackageData& PackageData) override;
+
+    /**
+     * Replace the tags of the listed assets of the package (an empty map removes the asset's entry) and persist the
+     * sidecar. The tags they replaced are returned so the change can be reverted. Used by undo and redo.
+     */
+    bool ReplaceTags(FName PackageName, const FTagsByAsset& Tags, FTagsByAsset& OutReplaced);
+
+    /** Return the sidecar filename for the package. */
+    static FString GetSidecarFilename(FName PackageName);
+
+private:
+    FTagsByAsset& GetSidecar(FName PackageName);
+    bool SaveSidecar(FName PackageName);
+    bool IsMigrated(FName PackageName);
+
+    // Return true if the sidecar on disk is the one this backend last wrote or deleted for the package
+    bool IsOwnWrite(FName PackageName) const;
+
+    void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+    void OnAssetRemoved(const FAssetData& AssetData);
+    void OnDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+    // Sidecars read so far, keyed by package name. A package without a sidecar has an empty entry.
+    TMap<FName, FTagsByAsset> SidecarsByPackage;
+
+    // Packages read so far that have no sidecar yet, so their metadata is still read from the package
+    TSet<FName> UnmigratedPackages;
+
+    // Hash of the contents of each sidecar this backend wrote, unset for one it deleted, so the directory watcher can
+    // ignore the changes it reports for them
+    TMap<FName, TOptional<uint64>> WrittenSidecarHashes;
+
+    FString WatchedDirectory;
+    FDelegateHandle DirectoryChangedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle AssetRemovedHandle;
+};
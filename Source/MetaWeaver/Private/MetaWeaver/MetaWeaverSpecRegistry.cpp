@@ -0,0 +1,482 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverSpecRegistry.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverProjectSettings.h"
+#include "MetaWeaver/MetaWeaverSpecRegistryCache.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+#include "UObject/SoftObjectPath.h"
+
+namespace
+{
+    using FSpecsByKey = TMap<FName, const FMetadataParameterSpec*>;
+
+    void GetActiveSetPaths(TArray<FSoftObjectPath>& OutPaths)
+    {
+        OutPaths.Reset();
+        if (const auto Settings = GetDefault<UMetaWeaverProjectSettings>())
+        {
+            for (const auto& SoftRoot : Settings->ActiveDefinitionSets)
+            {
+                OutPaths.Add(SoftRoot.ToSoftObjectPath());
+            }
+        }
+    }
+
+    void CollectIncludes(const UMetaWeaverMetadataDefinitionSet* Set, TArray<FSoftObjectPath>& OutIncludes)
+    {
+        OutIncludes.Reset(Set->MetadataDefinitionSets.Num());
+        for (const auto& SoftIncluded : Set->MetadataDefinitionSets)
+        {
+            OutIncludes.Add(SoftIncluded.ToSoftObjectPath());
+        }
+    }
+
+    // Group the specs declared by a set per ObjectType. A null ObjectType groups the unrestricted parameter sets.
+    void GroupSpecsByObjectType(const TArray<MetaWeaver::Aggregation::FFlattenedParameterSet>& ParameterSets,
+                                TMap<const UClass*, FSpecsByKey>& OutGroups)
+    {
+        for (const auto& Flattened : ParameterSets)
+        {
+            auto& SpecsByKey = OutGroups.FindOrAdd(Flattened.ParameterSet.ObjectType.Get());
+            for (const auto& Parameter : Flattened.ParameterSet.Parameters)
+            {
+                if (!Parameter.Key.IsNone())
+                {
+                    // Later parameter sets within the same definition set override earlier ones
+                    SpecsByKey.Add(Parameter.Key, &Parameter);
+                }
+            }
+        }
+    }
+
+    /**
+     * Collect the ObjectTypes and keys of the parameter sets whose relative order changed. Parameter sets of
+     * different ObjectTypes override each other in declaration order, so reordering them can change the spec that
+     * wins for a subclass of both without changing any per-ObjectType group.
+     */
+    void DiffOrder(const TArray<MetaWeaver::Aggregation::FFlattenedParameterSet>& OldSets,
+                   const TArray<MetaWeaver::Aggregation::FFlattenedParameterSet>& NewSets,
+                   TSet<const UClass*>& OutObjectTypes,
+                   TSet<FName>& OutKeys)
+    {
+        const auto IsSameType = [&OldSets, &NewSets](const int32 OldIndex, const int32 NewIndex) {
+            return OldSets[OldIndex].ParameterSet.ObjectType.Get() == NewSets[NewIndex].ParameterSet.ObjectType.Get();
+        };
+
+        // Only the span between the common prefix and the common suffix was reordered, added or removed
+        const auto NumCommon = FMath::Min(OldSets.Num(), NewSets.Num());
+        int32 NumPrefix{ 0 };
+        while (NumPrefix < NumCommon && IsSameType(NumPrefix, NumPrefix))
+        {
+            ++NumPrefix;
+        }
+        int32 NumSuffix{ 0 };
+        while (NumSuffix < NumCommon - NumPrefix
+               && IsSameType(OldSets.Num() - 1 - NumSuffix, NewSets.Num() - 1 - NumSuffix))
+        {
+            ++NumSuffix;
+        }
+
+        for (const auto Sets : { &OldSets, &NewSets })
+        {
+            for (auto Index = NumPrefix; Index < Sets->Num() - NumSuffix; ++Index)
+            {
+                const auto& ParameterSet = (*Sets)[Index].ParameterSet;
+                OutObjectTypes.Add(ParameterSet.ObjectType.Get());
+                for (const auto& Parameter : ParameterSet.Parameters)
+                {
+                    if (!Parameter.Key.IsNone())
+                    {
+                        OutKeys.Add(Parameter.Key);
+                    }
+                }
+            }
+        }
+    }
+
+    bool AreSpecsIdentical(const FMetadataParameterSpec& A, const FMetadataParameterSpec& B)
+    {
+        return FMetadataParameterSpec::StaticStruct()->CompareScriptStruct(&A, &B, PPF_None);
+    }
+
+    void DiffSpecs(const FSpecsByKey* OldSpecs, const FSpecsByKey* NewSpecs, TSet<FName>& OutChangedKeys)
+    {
+        if (OldSpecs)
+        {
+            for (const auto& [Key, OldSpec] : *OldSpecs)
+            {
+                const auto NewSpec = NewSpecs ? NewSpecs->FindRef(Key) : nullptr;
+                if (!NewSpec || !AreSpecsIdentical(*OldSpec, *NewSpec))
+                {
+                    OutChangedKeys.Add(Key);
+                }
+            }
+        }
+        if (NewSpecs)
+        {
+            for (const auto& [Key, NewSpec] : *NewSpecs)
+            {
+                if (!OldSpecs || !OldSpecs->Contains(Key))
+                {
+                    OutChangedKeys.Add(Key);
+                }
+            }
+        }
+    }
+} // namespace
+
+void FMetaWeaverSpecRegistry::Invalidate()
+{
+    if (bCompiled)
+    {
+        UE_LOG(LogMetaWeaver, Verbose, TEXT("Invalidating compiled MetaWeaver spec registry"));
+    }
+    bCompiled = false;
+    CompiledSets.Reset();
+    OrderedParameterSets.Reset();
+    ParameterSetIndex = MetaWeaver::Aggregation::FParameterSetIndex();
+    SpecsByClass.Reset();
+}
+
+void FMetaWeaverSpecRegistry::CompileIfRequired()
+{
+    if (!bCompiled)
+    {
+        METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_CompileRegistry);
+
+        TArray<FSoftObjectPath> ActiveSets;
+        GetActiveSetPaths(ActiveSets);
+
+        if (MetaWeaver::SpecRegistryCache::Load(ActiveSets, CompiledSets))
+        {
+            // The cached graph is current so none of the sets need to be loaded
+            CancelPreload();
+        }
+        else
+        {
+            if (bPreloading)
+            {
+                // A caller needs the specs before the preload completed. Loading synchronously below flushes any
+                // outstanding async requests for the same packages, so the remaining waves are no longer required.
+                UE_LOG(LogMetaWeaver, Verbose, TEXT("Spec registry requested before preload completed; loading now"));
+                CancelPreload();
+            }
+
+            TArray<UMetaWeaverMetadataDefinitionSet*> OrderedSets;
+            if (const auto Settings = GetDefault<UMetaWeaverProjectSettings>())
+            {
+                MetaWeaver::Aggregation::FlattenActiveSets(Settings->ActiveDefinitionSets, OrderedSets);
+            }
+            CompiledSets.Reset(OrderedSets.Num());
+            for (const auto Set : OrderedSets)
+            {
+                auto& Compiled = CompiledSets.AddDefaulted_GetRef();
+                Compiled.Path = FSoftObjectPath(Set);
+                CollectIncludes(Set, Compiled.Includes);
+                MetaWeaver::Aggregation::SnapshotParameterSets(Set, Compiled.ParameterSets);
+            }
+            MetaWeaver::SpecRegistryCache::Save(ActiveSets, CompiledSets);
+        }
+        FinishCompile();
+    }
+}
+
+void FMetaWeaverSpecRegistry::FinishCompile()
+{
+    RebuildOrderedParameterSets();
+    SpecsByClass.Reset();
+    bCompiled = true;
+
+    CompiledEvent.Broadcast();
+}
+
+void FMetaWeaverSpecRegistry::ApplyDefinitionSetChange(const UMetaWeaverMetadataDefinitionSet* Set,
+                                                       FMetaWeaverDefinitionSetsChange& OutChange)
+{
+    check(Set);
+
+    OutChange = FMetaWeaverDefinitionSetsChange();
+    OutChange.ChangedSet = Set;
+
+    if (!bCompiled)
+    {
+        // There is no snapshot to diff against, and listeners may hold specs resolved before the last invalidation
+        return;
+    }
+
+    const FSoftObjectPath SetPath(Set);
+    const auto Compiled = CompiledSets.FindByPredicate([&SetPath](const auto& C) { return C.Path == SetPath; });
+    if (!Compiled)
+    {
+        // The set is not part of the active include graph so nothing compiled depends on it
+        OutChange.bAffectsAll = false;
+        return;
+    }
+
+    TArray<FSoftObjectPath> Includes;
+    CollectIncludes(Set, Includes);
+    if (Includes != Compiled->Includes)
+    {
+        UE_LOG(LogMetaWeaver,
+               Verbose,
+               TEXT("Includes of MetaWeaverDefinitionSet %s changed; recompiling spec registry"),
+               *Set->GetName());
+        Invalidate();
+        return;
+    }
+
+    TArray<MetaWeaver::Aggregation::FFlattenedParameterSet> ParameterSets;
+    MetaWeaver::Aggregation::SnapshotParameterSets(Set, ParameterSets);
+
+    TMap<const UClass*, FSpecsByKey> OldGroups;
+    TMap<const UClass*, FSpecsByKey> NewGroups;
+    GroupSpecsByObjectType(Compiled->ParameterSets, OldGroups);
+    GroupSpecsByObjectType(ParameterSets, NewGroups);
+
+    TSet<const UClass*> ObjectTypes;
+    OldGroups.GetKeys(ObjectTypes);
+    for (const auto& [ObjectType, SpecsByKey] : NewGroups)
+    {
+        ObjectTypes.Add(ObjectType);
+    }
+
+    OutChange.bAffectsAll = false;
+    for (const auto ObjectType : ObjectTypes)
+    {
+        TSet<FName> ChangedKeys;
+        DiffSpecs(OldGroups.Find(ObjectType), NewGroups.Find(ObjectType), ChangedKeys);
+        if (ChangedKeys.Num() > 0)
+        {
+            if (ObjectType)
+            {
+                OutChange.AffectedObjectTypes.Add(ObjectType);
+            }
+            else
+            {
+                OutChange.bAffectsAllClasses = true;
+            }
+            OutChange.AffectedKeys.Append(ChangedKeys);
+        }
+    }
+
+    TSet<const UClass*> ReorderedObjectTypes;
+    TSet<FName> ReorderedKeys;
+    DiffOrder(Compiled->ParameterSets, ParameterSets, ReorderedObjectTypes, ReorderedKeys);
+    if (ReorderedKeys.Num() > 0)
+    {
+        for (const auto ObjectType : ReorderedObjectTypes)
+        {
+            if (ObjectType)
+            {
+                OutChange.AffectedObjectTypes.AddUnique(ObjectType);
+            }
+            else
+            {
+                OutChange.bAffectsAllClasses = true;
+            }
+        }
+        OutChange.AffectedKeys.Append(ReorderedKeys);
+    }
+
+    // The diff above references the old snapshot so it can only be replaced once the change has been computed
+    Compiled->ParameterSets = MoveTemp(ParameterSets);
+
+    if (!OutChange.IsEmpty())
+    {
+        RebuildOrderedParameterSets();
+
+        int32 Discarded{ 0 };
+        for (auto It = SpecsByClass.CreateIterator(); It; ++It)
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Class = Cast<UClass>(It.Key().ResolveObjectPtr());
+            if (!Class || OutChange.AffectsClass(Class))
+            {
+                It.RemoveCurrent();
+                ++Discarded;
+            }
+        }
+        UE_LOG(LogMetaWeaver,
+               Verbose,
+               TEXT("MetaWeaverDefinitionSet %s changed %d keys; discarded %d memoized spec tables"),
+               *Set->GetName(),
+               OutChange.AffectedKeys.Num(),
+               Discarded);
+    }
+}
+
+FMetaWeaverSpecTableRef FMetaWeaverSpecRegistry::GetSpecTableForClass(const UClass* Class)
+{
+    check(Class);
+
+    CompileIfRequired();
+
+    if (const auto Found = SpecsByClass.Find(FObjectKey(Class)))
+    {
+        INC_DWORD_STAT(STAT_MetaWeaver_SpecCacheHits);
+        return *Found;
+    }
+    else
+    {
+        INC_DWORD_STAT(STAT_MetaWeaver_SpecCacheMisses);
+
+        TArray<int32> MatchingIndices;
+        MetaWeaver::Aggregation::CollectParameterSetsForClass(Class, ParameterSetIndex, MatchingIndices);
+
+        TArray<FMetadataParameterSpec> Specs;
+        TArray<FTopLevelAssetPath> DeclaringTypes;
+        MetaWeaver::Aggregation::GatherSpecsForClassFromParameterSets(Class,
+                                                                      OrderedParameterSets,
+                                                                      MatchingIndices,
+                                                                      Specs,
+                                                                      DeclaringTypes);
+        const auto Table = 0 == Specs.Num()
+            ? FMetaWeaverSpecTable::Empty()
+            : MakeShared<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>(MoveTemp(Specs), MoveTemp(DeclaringTypes));
+        SpecsByClass.Add(FObjectKey(Class), Table);
+        return Table;
+    }
+}
+
+void FMetaWeaverSpecRegistry::BeginPreload()
+{
+    CancelPreload();
+
+    TArray<FSoftObjectPath> ActiveSets;
+    GetActiveSetPaths(ActiveSets);
+    if (!bCompiled && MetaWeaver::SpecRegistryCache::Load(ActiveSets, CompiledSets))
+    {
+        // The cached graph is current so there is nothing to preload
+        FinishCompile();
+    }
+    else
+    {
+        TArray<FSoftObjectPath> Roots;
+        for (const auto& Path : ActiveSets)
+        {
+            if (!Path.IsNull() && !PreloadVisited.Contains(Path))
+            {
+                PreloadVisited.Add(Path);
+                Roots.Add(Path);
+            }
+        }
+
+        bPreloading = true;
+        RequestPreloadWave(MoveTemp(Roots));
+    }
+}
+
+void FMetaWeaverSpecRegistry::RequestPreloadWave(TArray<FSoftObjectPath>&& Paths)
+{
+    if (0 == Paths.Num())
+    {
+        FinishPreload();
+    }
+    else
+    {
+        UE_LOG(LogMetaWeaver, Verbose, TEXT("Preloading %d MetaWeaverDefinitionSets"), Paths.Num());
+        auto Wave = Paths;
+        const auto Handle = StreamableManager.RequestAsyncLoad(
+            MoveTemp(Paths),
+            FStreamableDelegate::CreateSP(this, &FMetaWeaverSpecRegistry::OnPreloadWaveLoaded, MoveTemp(Wave)),
+            FStreamableManager::AsyncLoadHighPriority);
+        // The delegate may already have run if every set in the wave was resident, which ends the preload
+        if (bPreloading && Handle.IsValid())
+        {
+            PreloadHandles.Add(Handle);
+        }
+    }
+}
+
+// ReSharper disable once CppPassValueParameterByConstReference
+void FMetaWeaverSpecRegistry::OnPreloadWaveLoaded(const TArray<FSoftObjectPath> Wave)
+{
+    if (bPreloading)
+    {
+        // Request every not-yet-seen include of this wave as one batch so siblings load in parallel
+        TArray<FSoftObjectPath> NextWave;
+        for (const auto& Path : Wave)
+        {
+            if (const auto Set = Cast<UMetaWeaverMetadataDefinitionSet>(Path.ResolveObject()))
+            {
+                for (const auto& SoftIncluded : Set->MetadataDefinitionSets)
+                {
+                    // ReSharper disable once CppTooWideScopeInitStatement
+                    const auto& IncludedPath = SoftIncluded.ToSoftObjectPath();
+                    if (!IncludedPath.IsNull() && !PreloadVisited.Contains(IncludedPath))
+                    {
+                        PreloadVisited.Add(IncludedPath);
+                        NextWave.Add(IncludedPath);
+                    }
+                }
+            }
+            else
+            {
+                UE_LOG(LogMetaWeaver, Error, TEXT("Failed to preload MetaWeaverDefinitionSet %s"), *Path.ToString());
+            }
+        }
+        RequestPreloadWave(MoveTemp(NextWave));
+    }
+}
+
+void FMetaWeaverSpecRegistry::FinishPreload()
+{
+    bPreloading = false;
+    PreloadVisited.Reset();
+
+    // Every set is resident so compiling will not block on loads
+    CompileIfRequired();
+
+    // The registry holds its own snapshot so the sets no longer need to be pinned
+    ReleasePreloadHandles();
+}
+
+void FMetaWeaverSpecRegistry::CancelPreload()
+{
+    bPreloading = false;
+    PreloadVisited.Reset();
+    for (const auto& Handle : PreloadHandles)
+    {
+        if (Handle.IsValid())
+        {
+            Handle->CancelHandle();
+        }
+    }
+    PreloadHandles.Reset();
+}
+
+void FMetaWeaverSpecRegistry::ReleasePreloadHandles()
+{
+    for (const auto& Handle : PreloadHandles)
+    {
+        if (Handle.IsValid())
+        {
+            Handle->ReleaseHandle();
+        }
+    }
+    PreloadHandles.Reset();
+}
+
+void FMetaWeaverSpecRegistry::RebuildOrderedParameterSets()
+{
+    OrderedParameterSets.Reset();
+    for (const auto& Compiled : CompiledSets)
+    {
+        OrderedParameterSets.Append(Compiled.ParameterSets);
+    }
+    MetaWeaver::Aggregation::BuildParameterSetIndex(OrderedParameterSets, ParameterSetIndex);
+}
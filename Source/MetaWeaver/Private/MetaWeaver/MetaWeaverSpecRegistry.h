@@ -0,0 +1,108 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "MetaWeaver/MetaWeaverAggregation.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+
+class UMetaWeaverMetadataDefinitionSet;
+struct FMetaWeaverDefinitionSetsChange;
+
+/**
+ * Compiled form of the active definition sets.
+ * The include graph is flattened once and the resolved specs are memoized per class until the registry is
+ * invalidated, so repeated lookups do not reload or re-walk the definition sets.
+ *
+ * The definition set graph can be preloaded asynchronously so that the first lookup does not hitch the editor
+ * while every included set is loaded serially.
+ */
+class FMetaWeaverSpecRegistry final : public TSharedFromThis<FMetaWeaverSpecRegistry>
+{
+public:
+    /** Discard the flattened parameter sets and every memoized spec table. */
+    void Invalidate();
+
+    /** Return true if the active definition sets have been flattened since the last invalidation. */
+    bool IsCompiled() const { return bCompiled; }
+
+    /** Return true while an asynchronous preload of the definition set graph is in flight. */
+    bool IsPreloading() const { return bPreloading; }
+
+    /**
+     * Start loading the active definition sets and their includes through the streamable manager.
+     * Each level of includes is requested as a single batch so sibling sets load in parallel.
+     * The registry compiles once the whole graph is resident. Nothing is loaded if the on-disk cache of the
+     * compiled graph is current.
+     */
+    void BeginPreload();
+
+    /**
+     * Compile the active definition sets now, from the on-disk cache if it is current or otherwise by loading the
+     * sets synchronously, which completes any preload that is in flight.
+     */
+    void CompileIfRequired();
+
+    /**
+     * Patch the compiled registry after a single definition set was edited or saved and describe what changed.
+     * Only the spec tables memoized for affected classes are discarded. Falls back to a full invalidation if the
+     * registry is not compiled or the include graph of the set changed.
+     */
+    void ApplyDefinitionSetChange(const UMetaWeaverMetadataDefinitionSet* Set,
+                                  FMetaWeaverDefinitionSetsChange& OutChange);
+
+    /** Event fired whenever the registry finishes compiling the active definition sets. */
+    FSimpleMulticastDelegate& GetOnCompiled() { return CompiledEvent; }
+
+    /**
+     * Return the shared spec table for the class, compiling the registry first if required.
+     * The table is immutable and remains valid for as long as the caller holds it.
+     */
+    FMetaWeaverSpecTableRef GetSpecTableForClass(const UClass* Class);
+
+private:
+    void RequestPreloadWave(TArray<FSoftObjectPath>&& Paths);
+    void OnPreloadWaveLoaded(TArray<FSoftObjectPath> Wave);
+    void FinishPreload();
+    void CancelPreload();
+    void ReleasePreloadHandles();
+    void FinishCompile();
+    void RebuildOrderedParameterSets();
+
+    bool bCompiled{ false };
+    bool bPreloading{ false };
+
+    FSimpleMulticastDelegate CompiledEvent;
+
+    FStreamableManager StreamableManager;
+
+    // Handles pin the preloaded sets in memory until the registry has taken its snapshot
+    TArray<TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+    // Every set path that has been requested by the current preload
+    TSet<FSoftObjectPath> PreloadVisited;
+
+    // Every active definition set, in precedence order, so a single edited set can be diffed and patched
+    TArray<MetaWeaver::Aggregation::FCompiledSet> CompiledSets;
+
+    // Parameter sets from every active definition set, in precedence order (later entries win)
+    TArray<MetaWeaver::Aggregation::FFlattenedParameterSet> OrderedParameterSets;
+
+    // ObjectType -> contributing parameter sets, so resolution cost scales with hierarchy depth not schema size
+    MetaWeaver::Aggregation::FParameterSetIndex ParameterSetIndex;
+
+    // Memoized spec tables keyed by the class they were resolved for
+    TMap<FObjectKey, FMetaWeaverSpecTableRef> SpecsByClass;
+};
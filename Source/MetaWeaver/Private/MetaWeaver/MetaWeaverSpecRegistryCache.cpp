@@ -0,0 +1,245 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverSpecRegistryCache.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Hash/xxhash.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/Package.h"
+
+namespace
+{
+    constexpr uint32 CacheMagic = 0x4D575352; // 'MWSR'
+
+    // Bump whenever the layout written by SerializeCompiledSets changes
+    constexpr int32 CacheVersion = 1;
+
+    FString GetCacheFilename()
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MetaWeaver"), TEXT("SpecRegistry.bin"));
+    }
+
+    void UpdateHash(FXxHash64Builder& Builder, const FString& Value)
+    {
+        Builder.Update(*Value, Value.Len() * sizeof(TCHAR));
+    }
+
+    /**
+     * Hash the active set list and the saved hash of every set package.
+     * Fails if a set package is unknown to the asset registry. When reading, fails if any set package is loaded,
+     * as the in-memory set may differ from disk. When writing, only fails if a set package has unsaved changes.
+     */
+    bool ComputeKey(const TArray<FSoftObjectPath>& ActiveSets,
+                    const TArray<FString>& SetPaths,
+                    const bool bForWrite,
+                    uint64& OutKey)
+    {
+        auto& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+        FXxHash64Builder Builder;
+        Builder.Update(&CacheVersion, sizeof(CacheVersion));
+        for (const auto& Path : ActiveSets)
+        {
+            UpdateHash(Builder, Path.ToString());
+        }
+
+        for (const auto& SetPath : SetPaths)
+        {
+            const auto PackageName = FSoftObjectPath(SetPath).GetLongPackageFName();
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Package = FindObject<UPackage>(nullptr, *PackageName.ToString());
+            if (Package && (!bForWrite || Package->IsDirty()))
+            {
+                UE_LOG(LogMetaWeaver, Verbose, TEXT("Spec registry cache skipped; %s is loaded"), *SetPath);
+                return false;
+            }
+
+            auto PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+            if (!PackageData.IsSet())
+            {
+                // Commandlets may run before the registry has gathered the package, so scan just this file
+                FString Filename;
+                if (FPackageName::TryConvertLongPackageNameToFilename(PackageName.ToString(),
+                                                                       Filename,
+                                                                       FPackageName::GetAssetPackageExtension()))
+                {
+                    AssetRegistry.ScanFilesSynchronous({ Filename });
+                    PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+                }
+            }
+            if (!PackageData.IsSet())
+            {
+                UE_LOG(LogMetaWeaver, Verbose, TEXT("Spec registry cache skipped; %s is not registered"), *SetPath);
+                return false;
+            }
+
+            UpdateHash(Builder, SetPath);
+            const auto SavedHash = PackageData->GetPackageSavedHash();
+            Builder.Update(&SavedHash, sizeof(SavedHash));
+        }
+
+        OutKey = Builder.Finalize().Hash;
+        return true;
+    }
+
+    // Each element takes at least one byte, so a count the rest of the archive can not hold is corrupt
+    bool IsCountValid(FArchive& Ar, const int32 Count)
+    {
+        return Count >= 0 && (!Ar.IsLoading() || Count <= Ar.TotalSize() - Ar.Tell());
+    }
+
+    void SerializeCompiledSets(FArchive& Ar, TArray<MetaWeaver::Aggregation::FCompiledSet>& CompiledSets)
+    {
+        // Object references (ObjectType, AllowedClass) are stored as paths and resolved again on load
+        FObjectAndNameAsStringProxyArchive Proxy(Ar, /*bInLoadIfFindFails*/ true);
+
+        // A truncated or corrupt cache stops at the first error rather than sizing arrays from garbage
+        const auto HasFailed = [&Ar, &Proxy]() { return Ar.IsError() || Proxy.IsError(); };
+
+        int32 NumSets = CompiledSets.Num();
+        Proxy << NumSets;
+        if (HasFailed() || !IsCountValid(Proxy, NumSets))
+        {
+            Ar.SetError();
+            return;
+        }
+        if (Proxy.IsLoading())
+        {
+            CompiledSets.SetNum(NumSets);
+        }
+        for (auto& Compiled : CompiledSets)
+        {
+            Proxy << Compiled.Path;
+            Proxy << Compiled.Includes;
+
+            int32 NumParameterSets = Compiled.ParameterSets.Num();
+            Proxy << NumParameterSets;
+            if (HasFailed() || !IsCountValid(Proxy, NumParameterSets))
+            {
+                Ar.SetError();
+                return;
+            }
+            if (Proxy.IsLoading())
+            {
+                Compiled.ParameterSets.SetNum(NumParameterSets);
+            }
+            for (auto& Flattened : Compiled.ParameterSets)
+            {
+                Proxy << Flattened.SetName;
+                Proxy << Flattened.Index;
+                FMetaWeaverObjectParameterSet::StaticStruct()->SerializeItem(Proxy, &Flattened.ParameterSet, nullptr);
+                if (HasFailed())
+                {
+                    Ar.SetError();
+                    return;
+                }
+            }
+        }
+    }
+} // namespace
+
+namespace MetaWeaver::SpecRegistryCache
+{
+    bool Load(const TArray<FSoftObjectPath>& ActiveSets, TArray<Aggregation::FCompiledSet>& OutCompiledSets)
+    {
+        METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_LoadRegistryCache);
+
+        OutCompiledSets.Reset();
+
+        TArray<uint8> Bytes;
+        if (!FFileHelper::LoadFileToArray(Bytes, *GetCacheFilename(), FILEREAD_Silent))
+        {
+            return false;
+        }
+
+        FMemoryReader Reader(Bytes, /*bIsPersistent*/ true);
+        uint32 Magic{ 0 };
+        int32 Version{ 0 };
+        Reader << Magic;
+        Reader << Version;
+        if (CacheMagic != Magic || CacheVersion != Version || Reader.IsError())
+        {
+            UE_LOG(LogMetaWeaver, Verbose, TEXT("Spec registry cache has an unknown format; ignoring it"));
+            return false;
+        }
+
+        // The set paths are stored ahead of the payload so the key can be validated before deserializing it
+        TArray<FString> SetPaths;
+        uint64 StoredKey{ 0 };
+        Reader << SetPaths;
+        Reader << StoredKey;
+
+        uint64 Key{ 0 };
+        if (Reader.IsError() || !ComputeKey(ActiveSets, SetPaths, /*bForWrite*/ false, Key) || Key != StoredKey)
+        {
+            UE_LOG(LogMetaWeaver, Verbose, TEXT("Spec registry cache is out of date"));
+            return false;
+        }
+
+        SerializeCompiledSets(Reader, OutCompiledSets);
+        if (Reader.IsError())
+        {
+            UE_LOG(LogMetaWeaver, Warning, TEXT("Spec registry cache %s is corrupt; ignoring it"), *GetCacheFilename());
+            OutCompiledSets.Reset();
+            return false;
+        }
+
+        UE_LOG(LogMetaWeaver,
+               Log,
+               TEXT("Loaded %d MetaWeaverDefinitionSets from the spec registry cache"),
+               OutCompiledSets.Num());
+        return true;
+    }
+
+    void Save(const TArray<FSoftObjectPath>& ActiveSets, const TArray<Aggregation::FCompiledSet>& CompiledSets)
+    {
+        METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_SaveRegistryCache);
+
+        TArray<FString> SetPaths;
+        SetPaths.Reserve(CompiledSets.Num());
+        for (const auto& Compiled : CompiledSets)
+        {
+            SetPaths.Add(Compiled.Path.ToString());
+        }
+
+        uint64 Key{ 0 };
+        if (!ComputeKey(ActiveSets, SetPaths, /*bForWrite*/ true, Key))
+        {
+            return;
+        }
+
+        TArray<uint8> Bytes;
+        FMemoryWriter Writer(Bytes, /*bIsPersistent*/ true);
+        uint32 Magic{ CacheMagic };
+        int32 Version{ CacheVersion };
+        Writer << Magic;
+        Writer << Version;
+        Writer << SetPaths;
+        Writer << Key;
+        // Serialization is symmetric, so the writer needs a mutable view of the snapshot
+        SerializeCompiledSets(Writer, const_cast<TArray<Aggregation::FCompiledSet>&>(CompiledSets));
+
+        if (!FFileHelper::SaveArrayToFile(Bytes, *GetCacheFilename()))
+        {
+            UE_LOG(LogMetaWeaver, Warning, TEXT("Failed to write spec registry cache %s"), *GetCacheFilename());
+        }
+    }
+} // namespace MetaWeaver::SpecRegistryCache
@@ -0,0 +1,34 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverAggregation.h"
+
+/**
+ * Persists the compiled definition set graph under Saved/MetaWeaver so that editor startup and commandlets can
+ * resolve specs without loading any definition set packages.
+ *
+ * The cache is keyed by the ActiveDefinitionSets list and the saved hash of every set package in the graph, as
+ * reported by the asset registry. It is only used while none of the set packages are loaded, since in-memory
+ * sets may differ from what was saved.
+ */
+namespace MetaWeaver::SpecRegistryCache
+{
+    /** Read the compiled sets if the cache exists and matches the current active sets and set packages. */
+    bool Load(const TArray<FSoftObjectPath>& ActiveSets, TArray<Aggregation::FCompiledSet>& OutCompiledSets);
+
+    /** Write the compiled sets so the next session can skip loading the definition set packages. */
+    void Save(const TArray<FSoftObjectPath>& ActiveSets, const TArray<Aggregation::FCompiledSet>& CompiledSets);
+} // namespace MetaWeaver::SpecRegistryCache
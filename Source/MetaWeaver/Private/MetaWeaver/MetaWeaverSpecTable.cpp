@@ -0,0 +1,161 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+#include "Algo/BinarySearch.h"
+#include "Hash/xxhash.h"
+#include "MetaWeaver/MetaWeaverTypes.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+namespace
+{
+    bool IsOrdinalLess(const FStringView A, const FStringView B)
+    {
+        return A.Compare(B, ESearchCase::CaseSensitive) < 0;
+    }
+
+    bool IsInteger(const FStringView Value)
+    {
+        int64 Parsed{ 0 };
+        return FMetaWeaverValue::TryParseInteger(Value, Parsed);
+    }
+
+    bool IsFloat(const FStringView Value)
+    {
+        double Parsed{ 0.0 };
+        return FMetaWeaverValue::TryParseFloat(Value, Parsed);
+    }
+
+    bool IsBool(const FStringView Value)
+    {
+        bool bParsed{ false };
+        return FMetaWeaverValue::TryParseBool(Value, bParsed);
+    }
+
+    uint64 HashSpecs(TArray<FMetadataParameterSpec>& Specs)
+    {
+        TArray<uint8> Bytes;
+        FMemoryWriter Writer(Bytes, /*bIsPersistent*/ true);
+        // Object references (AllowedClass) are written as paths so the hash does not depend on the session
+        FObjectAndNameAsStringProxyArchive Proxy(Writer, /*bInLoadIfFindFails*/ false);
+        for (auto& Spec : Specs)
+        {
+            FMetadataParameterSpec::StaticStruct()->SerializeItem(Proxy, &Spec, nullptr);
+        }
+        return FXxHash64::HashBuffer(Bytes.GetData(), Bytes.Num()).Hash;
+    }
+} // namespace
+
+FMetaWeaverEnumMembership::FMetaWeaverEnumMembership(const TArray<FString>& Values)
+{
+    SortedValues.Reserve(Values.Num());
+    for (const auto& Value : Values)
+    {
+        SortedValues.Add(Value);
+    }
+    // PreSave sorts case-insensitively, so re-sort ordinally to match the case-sensitive comparison below
+    SortedValues.Sort(&IsOrdinalLess);
+}
+
+bool FMetaWeaverEnumMembership::Contains(const FStringView Value) const
+{
+    return INDEX_NONE != Algo::BinarySearch(SortedValues, Value, &IsOrdinalLess);
+}
+
+FMetaWeaverSpecValidator::FMetaWeaverSpecValidator(const FMetadataParameterSpec& Spec)
+{
+    switch (Spec.Type)
+    {
+        case EMetaWeaverValueType::Integer:
+            IsWellFormed = &IsInteger;
+            break;
+        case EMetaWeaverValueType::Float:
+            IsWellFormed = &IsFloat;
+            break;
+        case EMetaWeaverValueType::Bool:
+            IsWellFormed = &IsBool;
+            break;
+        case EMetaWeaverValueType::Enum:
+            bCheckEnumMembership = true;
+            EnumMembership = FMetaWeaverEnumMembership(Spec.EnumValues);
+            break;
+        case EMetaWeaverValueType::AssetReference:
+            IsWellFormed = &FMetaWeaverValue::IsValidAssetPathSyntax;
+            break;
+        case EMetaWeaverValueType::String:
+        default:
+            break;
+    }
+}
+
+EMetaWeaverValueCheck FMetaWeaverSpecValidator::Check(const FStringView Value) const
+{
+    if (IsWellFormed && !IsWellFormed(Value))
+    {
+        return EMetaWeaverValueCheck::Malformed;
+    }
+    else if (bCheckEnumMembership && !EnumMembership.Contains(Value))
+    {
+        return EMetaWeaverValueCheck::NotInEnum;
+    }
+    else
+    {
+        return EMetaWeaverValueCheck::Valid;
+    }
+}
+
+FMetaWeaverSpecTable::FMetaWeaverSpecTable(TArray<FMetadataParameterSpec>&& InSpecs,
+                                           TArray<FTopLevelAssetPath>&& InDeclaringTypes)
+    : Specs(MoveTemp(InSpecs))
+    , DeclaringTypes(MoveTemp(InDeclaringTypes))
+{
+    DeclaringTypes.SetNum(Specs.Num());
+    IndexByKey.Reserve(Specs.Num());
+    Validators.Reserve(Specs.Num());
+    for (int32 Index = 0; Index < Specs.Num(); ++Index)
+    {
+        const auto& Spec = Specs[Index];
+        IndexByKey.Add(Spec.Key, Index);
+        Validators.Emplace(Spec);
+        bHasUniqueSpecs |= Spec.bUnique;
+    }
+    ContentHash = HashSpecs(Specs);
+}
+
+const FMetadataParameterSpec* FMetaWeaverSpecTable::Find(const FName Key) const
+{
+    const auto Index = IndexByKey.Find(Key);
+    return Index ? &Specs[*Index] : nullptr;
+}
+
+const FMetaWeaverSpecValidator& FMetaWeaverSpecTable::GetValidator(const FMetadataParameterSpec& Spec) const
+{
+    const auto Index = static_cast<int32>(&Spec - Specs.GetData());
+    check(Validators.IsValidIndex(Index));
+    return Validators[Index];
+}
+
+const FTopLevelAssetPath& FMetaWeaverSpecTable::GetDeclaringType(const FMetadataParameterSpec& Spec) const
+{
+    const auto Index = static_cast<int32>(&Spec - Specs.GetData());
+    check(DeclaringTypes.IsValidIndex(Index));
+    return DeclaringTypes[Index];
+}
+
+const FMetaWeaverSpecTableRef& FMetaWeaverSpecTable::Empty()
+{
+    static const FMetaWeaverSpecTableRef EmptyTable =
+        MakeShared<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>(TArray<FMetadataParameterSpec>());
+    return EmptyTable;
+}
@@ -0,0 +1,150 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+
+/**
+ * Case-sensitive membership test for the allowed values of an Enum spec.
+ * Values are kept as views in ordinal order so a lookup is a binary search without allocating or hashing.
+ * The views reference the strings of the spec the membership was built from, so it must not outlive that spec.
+ */
+class FMetaWeaverEnumMembership final
+{
+public:
+    FMetaWeaverEnumMembership() = default;
+    explicit FMetaWeaverEnumMembership(const TArray<FString>& Values);
+
+    bool Contains(FStringView Value) const;
+
+    /** The allowed values in case-sensitive ordinal order. */
+    const TArray<FStringView>& GetSortedValues() const { return SortedValues; }
+
+    int32 Num() const { return SortedValues.Num(); }
+
+private:
+    TArray<FStringView> SortedValues;
+};
+
+/** Result of checking a value against a compiled spec. */
+enum class EMetaWeaverValueCheck : uint8
+{
+    Valid,
+
+    /** The value is not correctly formatted for the type of the spec. */
+    Malformed,
+
+    /** The value is well formed but is not one of the values of an Enum spec. */
+    NotInEnum
+};
+
+/**
+ * A spec compiled into the checks for its type when the spec table is built.
+ * Checking a value calls the format check selected at compile time directly on a view of the value, rather than
+ * switching on the type and round-tripping the value through FMetaWeaverValue, and does not allocate for values of
+ * typical length. The membership references the strings of the spec, so it must not outlive that spec.
+ */
+class FMetaWeaverSpecValidator final
+{
+public:
+    FMetaWeaverSpecValidator() = default;
+    explicit FMetaWeaverSpecValidator(const FMetadataParameterSpec& Spec);
+
+    EMetaWeaverValueCheck Check(FStringView Value) const;
+
+    /** The allowed values of an Enum spec. Empty for other spec types. */
+    const FMetaWeaverEnumMembership& GetEnumMembership() const { return EnumMembership; }
+
+private:
+    using FFormatCheck = bool (*)(FStringView);
+
+    // Null accepts any value
+    FFormatCheck IsWellFormed{ nullptr };
+    bool bCheckEnumMembership{ false };
+    FMetaWeaverEnumMembership EnumMembership;
+};
+
+/**
+ * The effective specs resolved for a class.
+ * Tables are immutable once built and are shared by reference between the spec registry, the validation subsystem
+ * and every editor row for an asset of the class, so resolving specs never copies them. A table stays valid for as
+ * long as a handle to it is held, even after the registry has been invalidated and resolved a newer table.
+ */
+class FMetaWeaverSpecTable final
+{
+public:
+    explicit FMetaWeaverSpecTable(TArray<FMetadataParameterSpec>&& InSpecs,
+                                  TArray<FTopLevelAssetPath>&& InDeclaringTypes = TArray<FTopLevelAssetPath>());
+
+    // The enum memberships view strings owned by Specs, so a table only ever lives behind FMetaWeaverSpecTableRef
+    FMetaWeaverSpecTable(const FMetaWeaverSpecTable&) = delete;
+    FMetaWeaverSpecTable(FMetaWeaverSpecTable&&) = delete;
+    FMetaWeaverSpecTable& operator=(const FMetaWeaverSpecTable&) = delete;
+    FMetaWeaverSpecTable& operator=(FMetaWeaverSpecTable&&) = delete;
+
+    /** The specs in resolution order. */
+    const TArray<FMetadataParameterSpec>& GetSpecs() const { return Specs; }
+
+    /** Return the spec for the key or nullptr if the class does not define the key. */
+    const FMetadataParameterSpec* Find(FName Key) const;
+
+    bool Contains(const FName Key) const { return IndexByKey.Contains(Key); }
+
+    /** Return the validator compiled for the spec. Spec must be an element of GetSpecs(). */
+    const FMetaWeaverSpecValidator& GetValidator(const FMetadataParameterSpec& Spec) const;
+
+    /**
+     * Return the membership compiled for an Enum spec of this table. Empty for other spec types.
+     * Spec must be an element of GetSpecs().
+     */
+    const FMetaWeaverEnumMembership& GetEnumMembership(const FMetadataParameterSpec& Spec) const
+    {
+        return GetValidator(Spec).GetEnumMembership();
+    }
+    int32 Num() const { return Specs.Num(); }
+
+    /**
+     * Return the ObjectType of the parameter set that declared the spec, or an empty path if it was declared by an
+     * unrestricted parameter set. Spec must be an element of GetSpecs().
+     */
+    const FTopLevelAssetPath& GetDeclaringType(const FMetadataParameterSpec& Spec) const;
+
+    /** Return true if any spec of the table requires its value to be unique across assets. */
+    bool HasUniqueSpecs() const { return bHasUniqueSpecs; }
+
+    /**
+     * Hash of the specs in the table. Object references are hashed by path so the hash is stable across sessions and
+     * can key results persisted to disk.
+     */
+    uint64 GetContentHash() const { return ContentHash; }
+
+    /** An empty table shared by every class that does not define any keys. */
+    static const TSharedRef<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>& Empty();
+
+private:
+    TArray<FMetadataParameterSpec> Specs;
+    TMap<FName, int32> IndexByKey;
+
+    // Parallel to Specs
+    TArray<FMetaWeaverSpecValidator> Validators;
+    TArray<FTopLevelAssetPath> DeclaringTypes;
+
+    uint64 ContentHash{ 0 };
+
+    bool bHasUniqueSpecs{ false };
+};
+
+using FMetaWeaverSpecTableRef = TSharedRef<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>;
+using FMetaWeaverSpecTablePtr = TSharedPtr<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>;
@@ -0,0 +1,52 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaverStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(MetaWeaverChannel);
+
+DEFINE_STAT(STAT_MetaWeaver_CompileRegistry);
+DEFINE_STAT(STAT_MetaWeaver_FlattenActiveSets);
+DEFINE_STAT(STAT_MetaWeaver_GatherSpecs);
+DEFINE_STAT(STAT_MetaWeaver_LoadRegistryCache);
+DEFINE_STAT(STAT_MetaWeaver_SaveRegistryCache);
+DEFINE_STAT(STAT_MetaWeaver_SpecCacheHits);
+DEFINE_STAT(STAT_MetaWeaver_SpecCacheMisses);
+
+DEFINE_STAT(STAT_MetaWeaver_ValidateAgainstSpecs);
+DEFINE_STAT(STAT_MetaWeaver_ValidateAssets);
+DEFINE_STAT(STAT_MetaWeaver_AssetsValidated);
+DEFINE_STAT(STAT_MetaWeaver_AssetsValidatedFromTags);
+DEFINE_STAT(STAT_MetaWeaver_AssetsLoadedForValidation);
+DEFINE_STAT(STAT_MetaWeaver_AssetReferencesLoaded);
+DEFINE_STAT(STAT_MetaWeaver_ValidationCacheHits);
+DEFINE_STAT(STAT_MetaWeaver_ValidationCacheMisses);
+DEFINE_STAT(STAT_MetaWeaver_BuildUniquenessIndex);
+
+DEFINE_STAT(STAT_MetaWeaver_IssueIndexTick);
+DEFINE_STAT(STAT_MetaWeaver_IssueIndexAssetsValidated);
+DEFINE_STAT(STAT_MetaWeaver_IssueIndexPendingAssets);
+
+DEFINE_STAT(STAT_MetaWeaver_MetadataIndexTick);
+DEFINE_STAT(STAT_MetaWeaver_MetadataIndexQuery);
+DEFINE_STAT(STAT_MetaWeaver_WriteMetadataIndexShard);
+DEFINE_STAT(STAT_MetaWeaver_MetadataIndexPendingPackages);
+
+DEFINE_STAT(STAT_MetaWeaver_ListMetadataTags);
+DEFINE_STAT(STAT_MetaWeaver_WriteMetadataTag);
+DEFINE_STAT(STAT_MetaWeaver_TagsWritten);
+
+DEFINE_STAT(STAT_MetaWeaver_BulkRecompute);
+DEFINE_STAT(STAT_MetaWeaver_BulkRebuildMatrix);
+DEFINE_STAT(STAT_MetaWeaver_BulkCommit);
+DEFINE_STAT(STAT_MetaWeaver_RowsProcessed);
@@ -0,0 +1,94 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+/**
+ * Trace channel for MetaWeaver CPU scopes. Enable with -trace=cpu,metaweaver (or "Trace.Enable MetaWeaver")
+ * to see the scopes in Unreal Insights.
+ */
+UE_TRACE_CHANNEL_EXTERN(MetaWeaverChannel);
+
+DECLARE_STATS_GROUP(TEXT("MetaWeaver"), STATGROUP_MetaWeaver, STATCAT_Advanced);
+
+// Spec resolution
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Compile Spec Registry"), STAT_MetaWeaver_CompileRegistry, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flatten Active Sets"), STAT_MetaWeaver_FlattenActiveSets, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Gather Specs For Class"), STAT_MetaWeaver_GatherSpecs, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Registry Cache"), STAT_MetaWeaver_LoadRegistryCache, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Registry Cache"), STAT_MetaWeaver_SaveRegistryCache, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spec Cache Hits"), STAT_MetaWeaver_SpecCacheHits, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spec Cache Misses"), STAT_MetaWeaver_SpecCacheMisses, STATGROUP_MetaWeaver, );
+
+// Validation
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Against Specs"), STAT_MetaWeaver_ValidateAgainstSpecs, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Assets (Batch)"), STAT_MetaWeaver_ValidateAssets, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Assets Validated"), STAT_MetaWeaver_AssetsValidated, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Assets Validated From Tags"),
+                                  STAT_MetaWeaver_AssetsValidatedFromTags,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Assets Loaded For Validation"),
+                                  STAT_MetaWeaver_AssetsLoadedForValidation,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Asset References Loaded"),
+                                  STAT_MetaWeaver_AssetReferencesLoaded,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Validation Cache Hits"),
+                                  STAT_MetaWeaver_ValidationCacheHits,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Validation Cache Misses"),
+                                  STAT_MetaWeaver_ValidationCacheMisses,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Uniqueness Index"),
+                          STAT_MetaWeaver_BuildUniquenessIndex,
+                          STATGROUP_MetaWeaver, );
+
+// Issue index
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Issue Index Tick"), STAT_MetaWeaver_IssueIndexTick, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Issue Index Assets Validated"),
+                                  STAT_MetaWeaver_IssueIndexAssetsValidated,
+                                  STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Issue Index Pending Assets"),
+                                  STAT_MetaWeaver_IssueIndexPendingAssets,
+                                  STATGROUP_MetaWeaver, );
+
+// Metadata index
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Metadata Index Tick"), STAT_MetaWeaver_MetadataIndexTick, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Metadata Index Query"), STAT_MetaWeaver_MetadataIndexQuery, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Write Metadata Index Shard"),
+                          STAT_MetaWeaver_WriteMetadataIndexShard,
+                          STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Metadata Index Pending Packages"),
+                                  STAT_MetaWeaver_MetadataIndexPendingPackages,
+                                  STATGROUP_MetaWeaver, );
+
+// Metadata store
+DECLARE_CYCLE_STAT_EXTERN(TEXT("List Metadata Tags"), STAT_MetaWeaver_ListMetadataTags, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Write Metadata Tag"), STAT_MetaWeaver_WriteMetadataTag, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Metadata Tags Written"), STAT_MetaWeaver_TagsWritten, STATGROUP_MetaWeaver, );
+
+// Bulk editor
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bulk Recompute Per Asset"), STAT_MetaWeaver_BulkRecompute, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bulk Rebuild Matrix"), STAT_MetaWeaver_BulkRebuildMatrix, STATGROUP_MetaWeaver, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bulk Commit"), STAT_MetaWeaver_BulkCommit, STATGROUP_MetaWeaver, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bulk Rows Processed"), STAT_MetaWeaver_RowsProcessed, STATGROUP_MetaWeaver, );
+
+/** Time the enclosing scope in the MetaWeaver stat group and emit a matching CPU event on the MetaWeaver channel. */
+#define METAWEAVER_SCOPE_CYCLE_COUNTER(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat);               \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, MetaWeaverChannel)
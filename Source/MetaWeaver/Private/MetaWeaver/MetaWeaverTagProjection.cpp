@@ -0,0 +1,76 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/MetaWeaverTagProjection.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "UObject/AssetRegistryTagsContext.h"
+
+namespace MetaWeaver::TagProjection
+{
+    namespace
+    {
+        // Bump when the layout of the projected tags changes so stale projections are ignored
+        const FString ProjectionVersion(TEXT("1"));
+        const FName ProjectionMarkerTag(TEXT("MetaWeaverProjection"));
+        const FString ProjectedTagPrefix(TEXT("MetaWeaver:"));
+    } // namespace
+
+    void AppendProjectedTags(FAssetRegistryTagsContext Context)
+    {
+        // Metadata is stripped from cooked content so there is nothing to project there
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Object = Context.GetObject();
+        if (Object && Object->IsAsset() && !Context.IsCooking())
+        {
+            if (const auto Tags = FMetaWeaverMetadataStore::FindMetadataTags(Object))
+            {
+                for (const auto& Tag : *Tags)
+                {
+                    Context.AddTag(UObject::FAssetRegistryTag(FName(ProjectedTagPrefix + Tag.Key.ToString()),
+                                                              Tag.Value,
+                                                              UObject::FAssetRegistryTag::TT_Hidden));
+                }
+            }
+            Context.AddTag(UObject::FAssetRegistryTag(ProjectionMarkerTag,
+                                                      ProjectionVersion,
+                                                      UObject::FAssetRegistryTag::TT_Hidden));
+        }
+    }
+
+    bool HasProjectedTags(const FAssetData& AssetData)
+    {
+        FString Version;
+        return AssetData.GetTagValue(ProjectionMarkerTag, Version) && ProjectionVersion == Version;
+    }
+
+    bool TryGetProjectedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags)
+    {
+        OutTags.Reset();
+
+        if (HasProjectedTags(AssetData))
+        {
+            for (const auto& TagAndValue : AssetData.TagsAndValues)
+            {
+                if (const auto TagName = TagAndValue.Key.ToString(); TagName.StartsWith(ProjectedTagPrefix))
+                {
+                    OutTags.Add(FName(TagName.RightChop(ProjectedTagPrefix.Len())), TagAndValue.Value.AsString());
+                }
+            }
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+} // namespace MetaWeaver::TagProjection
@@ -0,0 +1,42 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "AssetRegistry/AssetData.h"
+#include "CoreMinimal.h"
+
+class FAssetRegistryTagsContext;
+
+/**
+ * Projects the metadata of an asset into hidden asset registry tags when its package is saved, so that the metadata
+ * can be read from FAssetData without loading the asset.
+ *
+ * Every key of the asset's UMetaData is projected under a prefix, not just the keys covered by the current
+ * definitions, so the projection stays complete when the definition sets change. A marker tag records that the
+ * projection ran, which distinguishes "no metadata" from "saved before projection existed".
+ */
+namespace MetaWeaver::TagProjection
+{
+    /** Delegate target for FCoreUObjectDelegates::GetExtraObjectTagsWithContext. */
+    void AppendProjectedTags(FAssetRegistryTagsContext Context);
+
+    /** Return true if the asset was saved with a projection of its metadata, which may be empty. */
+    bool HasProjectedTags(const FAssetData& AssetData);
+
+    /**
+     * Read the projected metadata of the asset from its asset registry tags.
+     * Return false if the package was saved without a projection, in which case the asset must be loaded.
+     */
+    bool TryGetProjectedTags(const FAssetData& AssetData, TMap<FName, FString>& OutTags);
+} // namespace MetaWeaver::TagProjection
@@ -12,28 +12,18 @@
  * limitations under the License.
  */
 #include "MetaWeaverTypes.h"
-#include "String/LexFromString.h"
+#include "MetaWeaverNumericCodec.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverValueTypes)
 
-static bool ParseInt64(const FString& In, int64& Out)
-{
-    return LexTryParseString(Out, *In);
-}
-
-static bool ParseDouble(const FString& In, double& Out)
-{
-    return LexTryParseString(Out, *In);
-}
-
 FString FMetaWeaverValue::ToString() const
 {
     switch (Type)
     {
         case EMetaWeaverValueType::Integer:
-            return LexToString(IntValue);
+            return FMetaWeaverNumericCodec::FormatInteger(IntValue);
         case EMetaWeaverValueType::Float:
-            return LexToString(FloatValue);
+            return FMetaWeaverNumericCodec::FormatFloat(FloatValue);
         case EMetaWeaverValueType::String:
             return StringValue;
         case EMetaWeaverValueType::Bool:
@@ -47,7 +37,7 @@ FString FMetaWeaverValue::ToString() const
     }
 }
 
-bool FMetaWeaverValue::TryParse(const EMetaWeaverValueType TargetType, const FString& In, FMetaWeaverValue& Out)
+bool FMetaWeaverValue::TryParse(const EMetaWeaverValueType TargetType, const FStringView In, FMetaWeaverValue& Out)
 {
     switch (TargetType)
     {
@@ -55,7 +45,7 @@ bool FMetaWeaverValue::TryParse(const EMetaWeaverValueType TargetType, const FSt
         {
             // ReSharper disable once CppTooWideScopeInitStatement
             int64 V{ 0 };
-            if (!ParseInt64(In, V))
+            if (!TryParseInteger(In, V))
             {
                 return false;
             }
@@ -69,7 +59,7 @@ bool FMetaWeaverValue::TryParse(const EMetaWeaverValueType TargetType, const FSt
         {
             // ReSharper disable once CppTooWideScopeInitStatement
             double V{ 0.f };
-            if (!ParseDouble(In, V))
+            if (!TryParseFloat(In, V))
             {
                 return false;
             }
@@ -80,39 +70,71 @@ bool FMetaWeaverValue::TryParse(const EMetaWeaverValueType TargetType, const FSt
             }
         }
         case EMetaWeaverValueType::String:
-            Out = FromString(In);
+            Out = FromString(FString(In));
             return true;
         case EMetaWeaverValueType::Bool:
         {
-            const auto Lower = In.ToLower();
-            if (TEXT("true") == Lower || TEXT("1") == Lower)
+            // ReSharper disable once CppTooWideScopeInitStatement
+            bool bValue{ false };
+            if (!TryParseBool(In, bValue))
             {
-                Out = FromBool(true);
-                return true;
+                return false;
             }
-            else if (TEXT("false") == Lower || TEXT("0") == Lower)
+            else
             {
-                Out = FromBool(false);
+                Out = FromBool(bValue);
                 return true;
             }
-            else
+        }
+        case EMetaWeaverValueType::Enum:
+            Out = FromEnum(FName(In.Len(), In.GetData()));
+            return true;
+        case EMetaWeaverValueType::AssetReference:
+            if (!IsValidAssetPathSyntax(In))
             {
                 return false;
             }
+            else
+            {
+                Out = FromAsset(FSoftObjectPath(FString(In)));
+                return true;
+            }
+        default:
+            return false;
+    }
+}
+
+bool FMetaWeaverValue::IsValid(const EMetaWeaverValueType TargetType, const FStringView In)
+{
+    switch (TargetType)
+    {
+        case EMetaWeaverValueType::Integer:
+        {
+            int64 V{ 0 };
+            return TryParseInteger(In, V);
         }
+        case EMetaWeaverValueType::Float:
+        {
+            double V{ 0.0 };
+            return TryParseFloat(In, V);
+        }
+        case EMetaWeaverValueType::String:
         case EMetaWeaverValueType::Enum:
-            Out = FromEnum(FName(*In));
             return true;
+        case EMetaWeaverValueType::Bool:
+        {
+            bool bValue{ false };
+            return TryParseBool(In, bValue);
+        }
         case EMetaWeaverValueType::AssetReference:
-            Out = FromAsset(FSoftObjectPath(In));
-            return true;
+            return IsValidAssetPathSyntax(In);
         default:
             return false;
     }
 }
 
 bool FMetaWeaverValue::Canonicalize(const EMetaWeaverValueType TargetType,
-                                    const FString& In,
+                                    const FStringView In,
                                     FString& OutCanonicalValue)
 {
     // ReSharper disable once CppTooWideScopeInitStatement
@@ -127,3 +149,57 @@ bool FMetaWeaverValue::Canonicalize(const EMetaWeaverValueType TargetType,
         return true;
     }
 }
+
+bool FMetaWeaverValue::TryParseInteger(const FStringView In, int64& Out)
+{
+    return FMetaWeaverNumericCodec::TryParseInteger(In, Out);
+}
+
+bool FMetaWeaverValue::TryParseFloat(const FStringView In, double& Out)
+{
+    return FMetaWeaverNumericCodec::TryParseFloat(In, Out);
+}
+
+bool FMetaWeaverValue::TryParseBool(const FStringView In, bool& bOut)
+{
+    if (In.Equals(TEXT("true"), ESearchCase::IgnoreCase) || In.Equals(TEXT("1")))
+    {
+        bOut = true;
+        return true;
+    }
+    else if (In.Equals(TEXT("false"), ESearchCase::IgnoreCase) || In.Equals(TEXT("0")))
+    {
+        bOut = false;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool FMetaWeaverValue::IsValidAssetPathSyntax(const FStringView In)
+{
+    if (In.IsEmpty())
+    {
+        return true;
+    }
+    else if (!In.StartsWith(TEXT('/')))
+    {
+        return false;
+    }
+    else
+    {
+        const FStringView InvalidCharacters(INVALID_OBJECTPATH_CHARACTERS);
+        for (const auto Character : In)
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            int32 Index{ INDEX_NONE };
+            if (InvalidCharacters.FindChar(Character, Index))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
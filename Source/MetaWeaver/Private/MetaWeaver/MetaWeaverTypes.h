@@ -82,9 +82,34 @@ struct FMetaWeaverValue
     /** Canonical string form for persistence. */
     FString ToString() const;
 
-    /** Try to parse a string to a typed value of the requested type. */
-    static bool TryParse(EMetaWeaverValueType TargetType, const FString& In, FMetaWeaverValue& Out);
+    /**
+     * Try to parse a string to a typed value of the requested type.
+     * Integer, Float and Bool never allocate. String, Enum and AssetReference copy the string into the value.
+     */
+    static bool TryParse(EMetaWeaverValueType TargetType, FStringView In, FMetaWeaverValue& Out);
+
+    /**
+     * Return true if the string parses as the requested type, without producing the value.
+     * Never allocates and never touches the name table, so prefer it whenever only a yes/no answer is needed.
+     * Enum membership depends on the spec and is not checked.
+     */
+    static bool IsValid(EMetaWeaverValueType TargetType, FStringView In);
 
     /** Canonicalize a string by parsing as TargetType and re-serializing. */
-    static bool Canonicalize(EMetaWeaverValueType TargetType, const FString& In, FString& OutCanonicalValue);
+    static bool Canonicalize(EMetaWeaverValueType TargetType, FStringView In, FString& OutCanonicalValue);
+
+    /** Parse a whole string as a signed 64-bit integer using FMetaWeaverNumericCodec. */
+    static bool TryParseInteger(FStringView In, int64& Out);
+
+    /** Parse a whole string as a finite double using FMetaWeaverNumericCodec. */
+    static bool TryParseFloat(FStringView In, double& Out);
+
+    /** Parse "true"/"1" or "false"/"0", ignoring case. */
+    static bool TryParseBool(FStringView In, bool& bOut);
+
+    /**
+     * Return true if the string is empty (no reference) or has the shape of a long object path: it starts with '/'
+     * and contains none of the characters that are invalid in object paths.
+     */
+    static bool IsValidAssetPathSyntax(FStringView In);
 };
@@ -32,22 +32,6 @@ namespace MetaWeaver::UIHelpers
         }
     }
 
-    void BuildEnumOptionsFromSet(const TSet<FString>& Values, TArray<TSharedPtr<FString>>& OutOptions, const bool bSort)
-    {
-        OutOptions.Reset();
-        OutOptions.Reserve(Values.Num());
-        for (const auto& V : Values)
-        {
-            OutOptions.Add(MakeShared<FString>(V));
-        }
-        if (bSort)
-        {
-            OutOptions.Sort([](const auto& A, const auto& B) {
-                return (A.IsValid() ? *A : TEXT("")) < (B.IsValid() ? *B : TEXT(""));
-            });
-        }
-    }
-
     const TArray<TSharedPtr<FString>>& GetOrBuildEnumOptions(TMap<FName, TArray<TSharedPtr<FString>>>& Cache,
                                                              const FMetadataParameterSpec& Spec,
                                                              const bool bSort)
@@ -25,13 +25,6 @@ namespace MetaWeaver::UIHelpers
      */
     void BuildEnumOptions(const TArray<FString>& Values, TArray<TSharedPtr<FString>>& OutOptions, bool bSort = true);
 
-    /**
-     * Populate an Options array for SComboBox from a set of enum strings.
-     * Resets OutOptions and appends shared string entries. Optionally sorts.
-     */
-    void
-    BuildEnumOptionsFromSet(const TSet<FString>& Values, TArray<TSharedPtr<FString>>& OutOptions, bool bSort = true);
-
     /**
      * Get or build cached enum options for the given spec key.
      * Ensures the returned reference refers to an array stored in Cache (stable for SComboBox OptionsSource).
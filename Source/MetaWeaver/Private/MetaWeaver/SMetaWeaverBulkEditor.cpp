@@ -17,10 +17,12 @@
 #include "Editor.h"
 #include "IContentBrowserSingleton.h"
 #include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverNumericCodec.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
 #include "MetaWeaverEditorSettings.h"
 #include "MetaWeaverLogging.h"
+#include "MetaWeaverStats.h"
 #include "MetaWeaverStyle.h"
 #include "MetaWeaverUIHelpers.h"
 #include "PropertyCustomizationHelpers.h"
@@ -58,6 +60,8 @@ void SMetaWeaverBulkEditor::Construct(const FArguments& InArgs)
     // External change notifications
     ObjectModifiedHandle =
         FCoreUObjectDelegates::OnObjectModified.AddSP(this, &SMetaWeaverBulkEditor::OnObjectModified);
+    MetadataChangedHandle =
+        FMetaWeaverMetadataStore::OnMetadataChanged().AddSP(this, &SMetaWeaverBulkEditor::OnMetadataChanged);
 
     // AssetRegistry updates/removal/rename
     {
@@ -99,6 +103,10 @@ SMetaWeaverBulkEditor::~SMetaWeaverBulkEditor()
     {
         FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
     }
+    if (MetadataChangedHandle.IsValid())
+    {
+        FMetaWeaverMetadataStore::OnMetadataChanged().Remove(MetadataChangedHandle);
+    }
     if (AssetRemovedHandle.IsValid() || AssetRenamedHandle.IsValid() || AssetUpdatedHandle.IsValid())
     {
         if (const auto Module = FModuleManager::Get().GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
@@ -218,20 +226,34 @@ void SMetaWeaverBulkEditor::BuildUI()
 
 void SMetaWeaverBulkEditor::RecomputeCandidateColumnsAndPerAsset()
 {
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkRecompute);
+
     const auto Count = SelectedAssets.Num();
     PerAsset.Reset();
     PerAsset.SetNum(Count);
-    CandidateColumns.Reset();
-    TSet<FName> Keys;
 
     for (auto i = 0; i < Count; ++i)
     {
         UpdatePerAssetData(i);
-        for (const auto& Pair : PerAsset[i].Specs)
+    }
+    RecomputeCandidateColumns();
+}
+
+void SMetaWeaverBulkEditor::RecomputeCandidateColumns()
+{
+    CandidateColumns.Reset();
+    TSet<FName> Keys;
+
+    for (const auto& Computed : PerAsset)
+    {
+        if (Computed.Specs.IsValid())
         {
-            Keys.Add(Pair.Key);
+            for (const auto& Spec : Computed.Specs->GetSpecs())
+            {
+                Keys.Add(Spec.Key);
+            }
         }
-        for (const auto& Pair : PerAsset[i].Tags)
+        for (const auto& Pair : Computed.Tags)
         {
             Keys.Add(Pair.Key);
         }
@@ -245,246 +267,18 @@ void SMetaWeaverBulkEditor::RecomputeCandidateColumnsAndPerAsset()
 
 void SMetaWeaverBulkEditor::RebuildMatrix()
 {
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkRebuildMatrix);
+
     const auto Header = SNew(SHeaderRow)
         + SHeaderRow::Column(NAME_Show).FixedWidth(28.f).DefaultLabel(FText::FromString(TEXT("")))
         + SHeaderRow::Column(NAME_Open).FixedWidth(28.f).DefaultLabel(FText::FromString(TEXT("")))
         + SHeaderRow::Column(NAME_Asset).FillWidth(0.3f).DefaultLabel(FText::FromString(TEXT("Asset")));
-    const float KeyCols = PinnedKeys.Num() > 0 ? 0.7f / PinnedKeys.Num() : 0.7f;
+    const auto KeyCols = GetPinnedColumnFillWidth();
     for (const auto& Key : PinnedKeys)
     {
-        TSharedPtr<SEditableTextBox> HeaderText;
-        TSharedPtr<SCheckBox> HeaderBool;
-        TSharedPtr<SNumericEntryBox<int64>> HeaderInt;
-        TSharedPtr<int64> HeaderIntValue;
-        TSharedPtr<SNumericEntryBox<double>> HeaderFloat;
-        TSharedPtr<double> HeaderFloatValue;
-        TArray<TSharedPtr<FString>> HeaderEnumValues;
-        TSharedPtr<SComboBox<TSharedPtr<FString>>> HeaderEnum;
-        TSharedPtr<FString> HeaderEnumSelected;
-        TSharedPtr<FString> HeaderAssetPath;
-        const auto Description = DeriveColumnDescription(Key);
-
-        // Derive a coherent header editor type if possible
-        const auto TypeOpt = DeriveColumnType(Key);
-        const bool bMixedTypes = !TypeOpt.IsSet();
-        const auto HeaderType = TypeOpt.Get(EMetaWeaverValueType::String);
-
-        Header->AddColumn(
-            SHeaderRow::Column(Key).FillWidth(KeyCols).HeaderContent()
-                [SNew(SVerticalBox)
-                 + SVerticalBox::Slot().AutoHeight()
-                       [SNew(STextBlock)
-                            .Text(FText::FromName(Key))
-                            .ToolTipText(Description.IsEmpty() ? FText::GetEmpty() : FText::FromString(Description))]
-                 + SVerticalBox::Slot().AutoHeight().Padding(0.f, 2.f)[SNew(SBox).HAlign(
-                     HAlign_Fill)[bMixedTypes ? SAssignNew(HeaderText, SEditableTextBox)
-                                                    .HintText(FText::FromString(TEXT("Value")))
-                                              : [&]() -> TSharedRef<SWidget> {
-                       switch (HeaderType)
-                       {
-                           case EMetaWeaverValueType::Bool:
-                           {
-                               SAssignNew(HeaderBool, SCheckBox).IsChecked(ECheckBoxState::Unchecked);
-                               return HeaderBool.ToSharedRef();
-                           }
-                           case EMetaWeaverValueType::Integer:
-                           {
-                               HeaderIntValue = MakeShared<int64>(0);
-                               SAssignNew(HeaderInt, SNumericEntryBox<int64>)
-                                   .AllowSpin(true)
-                                   .MinDesiredValueWidth(60.f)
-                                   .Value_Lambda([HeaderIntValue]() -> TOptional<int64> {
-                                       return HeaderIntValue.IsValid() ? TOptional(*HeaderIntValue)
-                                                                       : TOptional<int64>();
-                                   })
-                                   .OnValueChanged_Lambda(
-                                       [HeaderIntValue](const int64 NewVal) { *HeaderIntValue = NewVal; });
-                               return HeaderInt.ToSharedRef();
-                           }
-                           case EMetaWeaverValueType::Float:
-                           {
-                               HeaderFloatValue = MakeShared<double>(0.0);
-                               SAssignNew(HeaderFloat, SNumericEntryBox<double>)
-                                   .AllowSpin(true)
-                                   .MinDesiredValueWidth(60.f)
-                                   .Value_Lambda([HeaderFloatValue]() -> TOptional<double> {
-                                       return HeaderFloatValue.IsValid() ? TOptional(*HeaderFloatValue)
-                                                                         : TOptional<double>();
-                                   })
-                                   .OnValueChanged_Lambda(
-                                       [HeaderFloatValue](double NewVal) { *HeaderFloatValue = NewVal; });
-                               return HeaderFloat.ToSharedRef();
-                           }
-                           case EMetaWeaverValueType::Enum:
-                           {
-                               const auto& OptionsRef = BuildHeaderEnumOptions(Key);
-                               HeaderEnumSelected = MakeShared<FString>(TEXT(""));
-                               SAssignNew(HeaderEnum, SComboBox<TSharedPtr<FString>>)
-                                   .OptionsSource(&OptionsRef)
-                                   .OnGenerateWidget_Lambda([](const TSharedPtr<FString>& InItem) {
-                                       return SNew(STextBlock)
-                                           .Text(FText::FromString(InItem.IsValid() ? *InItem : TEXT("")));
-                                   })
-                                   .OnSelectionChanged_Lambda(
-                                       [HeaderEnumSelected](const TSharedPtr<FString>& NewItem, ESelectInfo::Type) {
-                                           if (NewItem.IsValid())
-                                           {
-                                               *HeaderEnumSelected = *NewItem;
-                                           }
-                                       })[SNew(STextBlock).Text_Lambda([HeaderEnumSelected]() -> FText {
-                                       return HeaderEnumSelected.IsValid() ? FText::FromString(*HeaderEnumSelected)
-                                                                           : FText();
-                                   })];
-                               return HeaderEnum.ToSharedRef();
-                           }
-                           case EMetaWeaverValueType::AssetReference:
-                           {
-                               const auto Allowed = DeriveHeaderAllowedClass(Key);
-                               HeaderAssetPath = MakeShared<FString>();
-                               return SNew(SObjectPropertyEntryBox)
-                                   .AllowedClass(Allowed)
-                                   .AllowClear(true)
-                                   .DisplayUseSelected(true)
-                                   .DisplayBrowse(true)
-                                   .OnObjectChanged_Lambda([HeaderAssetPath](const FAssetData& NewAsset) {
-                                       *HeaderAssetPath =
-                                           NewAsset.IsValid() ? NewAsset.ToSoftObjectPath().ToString() : FString();
-                                   });
-                           }
-                           case EMetaWeaverValueType::String:
-                           default:
-                           {
-                               return SAssignNew(HeaderText, SEditableTextBox)
-                                   .HintText(FText::FromString(TEXT("Value")));
-                           }
-                       }
-                   }()]]
-                 + SVerticalBox::Slot().AutoHeight()
-                       [SNew(SHorizontalBox)
-                        + SHorizontalBox::Slot().AutoWidth().Padding(0.f, 0.f, 2.f, 0.f)
-                              [SNew(SButton)
-                                   .ToolTipText(FText::FromString(TEXT("Apply Value Change")))
-                                   .IsEnabled_Lambda([this,
-                                                      Key,
-                                                      HeaderText,
-                                                      HeaderBool,
-                                                      HeaderIntValue,
-                                                      HeaderFloatValue,
-                                                      HeaderEnumSelected,
-                                                      HeaderAssetPath,
-                                                      bMixedTypes,
-                                                      HeaderType] {
-                                       auto CurrentVal = [&]() -> FString {
-                                           if (bMixedTypes)
-                                           {
-                                               return HeaderText.IsValid() ? HeaderText->GetText().ToString()
-                                                                           : FString();
-                                           }
-                                           switch (HeaderType)
-                                           {
-                                               case EMetaWeaverValueType::Bool:
-                                                   return HeaderBool.IsValid()
-                                                           && HeaderBool->GetCheckedState() == ECheckBoxState::Checked
-                                                       ? TEXT("True")
-                                                       : TEXT("False");
-                                               case EMetaWeaverValueType::Integer:
-                                                   return HeaderIntValue.IsValid() ? LexToString(*HeaderIntValue)
-                                                                                   : FString();
-                                               case EMetaWeaverValueType::Float:
-                                                   return HeaderFloatValue.IsValid() ? LexToString(*HeaderFloatValue)
-                                                                                     : FString();
-                                               case EMetaWeaverValueType::Enum:
-                                                   return HeaderEnumSelected.IsValid() ? *HeaderEnumSelected
-                                                                                       : FString();
-                                               case EMetaWeaverValueType::AssetReference:
-                                                   return HeaderAssetPath.IsValid() ? *HeaderAssetPath : FString();
-                                               case EMetaWeaverValueType::String:
-                                               default:
-                                                   return HeaderText.IsValid() ? HeaderText->GetText().ToString()
-                                                                               : FString();
-                                           }
-                                       }();
-                                       return IsApplyEnabled(Key, CurrentVal);
-                                   })
-                                   .OnClicked_Lambda([this,
-                                                      Key,
-                                                      HeaderText,
-                                                      HeaderBool,
-                                                      HeaderIntValue,
-                                                      HeaderFloatValue,
-                                                      HeaderEnumSelected,
-                                                      HeaderAssetPath,
-                                                      bMixedTypes,
-                                                      HeaderType] {
-                                       FString NewVal;
-                                       if (bMixedTypes)
-                                       {
-                                           NewVal = HeaderText.IsValid() ? HeaderText->GetText().ToString() : FString();
-                                       }
-                                       else
-                                       {
-                                           switch (HeaderType)
-                                           {
-                                               case EMetaWeaverValueType::Bool:
-                                                   NewVal = HeaderBool.IsValid()
-                                                           && HeaderBool->GetCheckedState() == ECheckBoxState::Checked
-                                                       ? TEXT("True")
-                                                       : TEXT("False");
-                                                   break;
-                                               case EMetaWeaverValueType::Integer:
-                                                   NewVal = HeaderIntValue.IsValid() ? LexToString(*HeaderIntValue)
-                                                                                     : FString();
-                                                   break;
-                                               case EMetaWeaverValueType::Float:
-                                                   NewVal = HeaderFloatValue.IsValid() ? LexToString(*HeaderFloatValue)
-                                                                                       : FString();
-                                                   break;
-                                               case EMetaWeaverValueType::Enum:
-                                                   NewVal =
-                                                       HeaderEnumSelected.IsValid() ? *HeaderEnumSelected : FString();
-                                                   break;
-                                               case EMetaWeaverValueType::AssetReference:
-                                                   NewVal = HeaderAssetPath.IsValid() ? *HeaderAssetPath : FString();
-                                                   break;
-                                               case EMetaWeaverValueType::String:
-                                               default:
-                                                   NewVal = HeaderText.IsValid() ? HeaderText->GetText().ToString()
-                                                                                 : FString();
-                                                   break;
-                                           }
-                                       }
-                                       ApplyColumnValueToAll(Key, NewVal);
-                                       return FReply::Handled();
-                                   })[SNew(SBox)
-                                          .HAlign(HAlign_Center)
-                                          .VAlign(VAlign_Center)
-                                          .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
-                                              FMetaWeaverStyle::GetCheckBrush())]]]
-                        + SHorizontalBox::Slot().AutoWidth().Padding(0.f, 0.f, 2.f, 0.f)
-                              [SNew(SButton)
-                                   .ToolTipText(FText::FromString(TEXT("Reset all values to default")))
-                                   .IsEnabled_Lambda([this, Key] { return IsResetEnabled(Key); })
-                                   .OnClicked_Lambda([this, Key] {
-                                       ResetColumnForAll(Key);
-                                       return FReply::Handled();
-                                   })[SNew(SBox)
-                                          .HAlign(HAlign_Center)
-                                          .VAlign(VAlign_Center)
-                                          .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
-                                              FMetaWeaverStyle::GetResetToDefaultBrush())]]]
-                        + SHorizontalBox::Slot()
-                              .AutoWidth()[SNew(SButton)
-                                               .ToolTipText(FText::FromString(TEXT("Remove all")))
-                                               .IsEnabled_Lambda([this, Key] { return IsDeleteEnabled(Key); })
-                                               .OnClicked_Lambda([this, Key] {
-                                                   RemoveColumnForAll(Key);
-                                                   return FReply::Handled();
-                                               })[SNew(SBox)
-                                                      .HAlign(HAlign_Center)
-                                                      .VAlign(VAlign_Center)
-                                                      .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
-                                                          FMetaWeaverStyle::GetDeleteBrush())]]]]]);
+        Header->AddColumn(BuildPinnedColumn(Key, KeyCols));
     }
+    MatrixHeader = Header;
 
     // Asset rows backing store (must outlive the ListView)
     AssetItems.Reset();
@@ -506,6 +300,250 @@ void SMetaWeaverBulkEditor::RebuildMatrix()
     }
 }
 
+float SMetaWeaverBulkEditor::GetPinnedColumnFillWidth() const
+{
+    return PinnedKeys.Num() > 0 ? 0.7f / PinnedKeys.Num() : 0.7f;
+}
+
+SHeaderRow::FColumn::FArguments SMetaWeaverBulkEditor::BuildPinnedColumn(const FName& Key, const float FillWidth)
+{
+    TSharedPtr<SEditableTextBox> HeaderText;
+    TSharedPtr<SCheckBox> HeaderBool;
+    TSharedPtr<SNumericEntryBox<int64>> HeaderInt;
+    TSharedPtr<int64> HeaderIntValue;
+    TSharedPtr<SNumericEntryBox<double>> HeaderFloat;
+    TSharedPtr<double> HeaderFloatValue;
+    TArray<TSharedPtr<FString>> HeaderEnumValues;
+    TSharedPtr<SComboBox<TSharedPtr<FString>>> HeaderEnum;
+    TSharedPtr<FString> HeaderEnumSelected;
+    TSharedPtr<FString> HeaderAssetPath;
+    const auto Description = DeriveColumnDescription(Key);
+
+    // Derive a coherent header editor type if possible
+    const auto TypeOpt = DeriveColumnType(Key);
+    const bool bMixedTypes = !TypeOpt.IsSet();
+    const auto HeaderType = TypeOpt.Get(EMetaWeaverValueType::String);
+
+    return SHeaderRow::Column(Key).FillWidth(FillWidth).HeaderContent()
+        [SNew(SVerticalBox)
+         + SVerticalBox::Slot().AutoHeight()
+               [SNew(STextBlock)
+                    .Text(FText::FromName(Key))
+                    .ToolTipText(Description.IsEmpty() ? FText::GetEmpty() : FText::FromString(Description))]
+         + SVerticalBox::Slot().AutoHeight().Padding(0.f, 2.f)[SNew(SBox).HAlign(
+             HAlign_Fill)[bMixedTypes ? SAssignNew(HeaderText, SEditableTextBox)
+                                            .HintText(FText::FromString(TEXT("Value")))
+                                      : [&]() -> TSharedRef<SWidget> {
+               switch (HeaderType)
+               {
+                   case EMetaWeaverValueType::Bool:
+                   {
+                       SAssignNew(HeaderBool, SCheckBox).IsChecked(ECheckBoxState::Unchecked);
+                       return HeaderBool.ToSharedRef();
+                   }
+                   case EMetaWeaverValueType::Integer:
+                   {
+                       HeaderIntValue = MakeShared<int64>(0);
+                       SAssignNew(HeaderInt, SNumericEntryBox<int64>)
+                           .AllowSpin(true)
+                           .MinDesiredValueWidth(60.f)
+                           .Value_Lambda([HeaderIntValue]() -> TOptional<int64> {
+                               return HeaderIntValue.IsValid() ? TOptional(*HeaderIntValue)
+                                                               : TOptional<int64>();
+                           })
+                           .OnValueChanged_Lambda(
+                               [HeaderIntValue](const int64 NewVal) { *HeaderIntValue = NewVal; });
+                       return HeaderInt.ToSharedRef();
+                   }
+                   case EMetaWeaverValueType::Float:
+                   {
+                       HeaderFloatValue = MakeShared<double>(0.0);
+                       SAssignNew(HeaderFloat, SNumericEntryBox<double>)
+                           .AllowSpin(true)
+                           .MinDesiredValueWidth(60.f)
+                           .Value_Lambda([HeaderFloatValue]() -> TOptional<double> {
+                               return HeaderFloatValue.IsValid() ? TOptional(*HeaderFloatValue)
+                                                                 : TOptional<double>();
+                           })
+                           .OnValueChanged_Lambda(
+                               [HeaderFloatValue](double NewVal) { *HeaderFloatValue = NewVal; });
+                       return HeaderFloat.ToSharedRef();
+                   }
+                   case EMetaWeaverValueType::Enum:
+                   {
+                       const auto& OptionsRef = BuildHeaderEnumOptions(Key);
+                       HeaderEnumSelected = MakeShared<FString>(TEXT(""));
+                       SAssignNew(HeaderEnum, SComboBox<TSharedPtr<FString>>)
+                           .OptionsSource(&OptionsRef)
+                           .OnGenerateWidget_Lambda([](const TSharedPtr<FString>& InItem) {
+                               return SNew(STextBlock)
+                                   .Text(FText::FromString(InItem.IsValid() ? *InItem : TEXT("")));
+                           })
+                           .OnSelectionChanged_Lambda(
+                               [HeaderEnumSelected](const TSharedPtr<FString>& NewItem, ESelectInfo::Type) {
+                                   if (NewItem.IsValid())
+                                   {
+                                       *HeaderEnumSelected = *NewItem;
+                                   }
+                               })[SNew(STextBlock).Text_Lambda([HeaderEnumSelected]() -> FText {
+                               return HeaderEnumSelected.IsValid() ? FText::FromString(*HeaderEnumSelected)
+                                                                   : FText();
+                           })];
+                       return HeaderEnum.ToSharedRef();
+                   }
+                   case EMetaWeaverValueType::AssetReference:
+                   {
+                       const auto Allowed = DeriveHeaderAllowedClass(Key);
+                       HeaderAssetPath = MakeShared<FString>();
+                       return SNew(SObjectPropertyEntryBox)
+                           .AllowedClass(Allowed)
+                           .AllowClear(true)
+                           .DisplayUseSelected(true)
+                           .DisplayBrowse(true)
+                           .OnObjectChanged_Lambda([HeaderAssetPath](const FAssetData& NewAsset) {
+                               *HeaderAssetPath =
+                                   NewAsset.IsValid() ? NewAsset.ToSoftObjectPath().ToString() : FString();
+                           });
+                   }
+                   case EMetaWeaverValueType::String:
+                   default:
+                   {
+                       return SAssignNew(HeaderText, SEditableTextBox)
+                           .HintText(FText::FromString(TEXT("Value")));
+                   }
+               }
+           }()]]
+         + SVerticalBox::Slot().AutoHeight()
+               [SNew(SHorizontalBox)
+                + SHorizontalBox::Slot().AutoWidth().Padding(0.f, 0.f, 2.f, 0.f)
+                      [SNew(SButton)
+                           .ToolTipText(FText::FromString(TEXT("Apply Value Change")))
+                           .IsEnabled_Lambda([this,
+                                              Key,
+                                              HeaderText,
+                                              HeaderBool,
+                                              HeaderIntValue,
+                                              HeaderFloatValue,
+                                              HeaderEnumSelected,
+                                              HeaderAssetPath,
+                                              bMixedTypes,
+                                              HeaderType] {
+                               auto CurrentVal = [&]() -> FString {
+                                   if (bMixedTypes)
+                                   {
+                                       return HeaderText.IsValid() ? HeaderText->GetText().ToString()
+                                                                   : FString();
+                                   }
+                                   switch (HeaderType)
+                                   {
+                                       case EMetaWeaverValueType::Bool:
+                                           return HeaderBool.IsValid()
+                                                   && HeaderBool->GetCheckedState() == ECheckBoxState::Checked
+                                               ? TEXT("True")
+                                               : TEXT("False");
+                                       case EMetaWeaverValueType::Integer:
+                                           return HeaderIntValue.IsValid()
+                                               ? FMetaWeaverNumericCodec::FormatInteger(*HeaderIntValue)
+                                               : FString();
+                                       case EMetaWeaverValueType::Float:
+                                           return HeaderFloatValue.IsValid()
+                                               ? FMetaWeaverNumericCodec::FormatFloat(*HeaderFloatValue)
+                                               : FString();
+                                       case EMetaWeaverValueType::Enum:
+                                           return HeaderEnumSelected.IsValid() ? *HeaderEnumSelected
+                                                                               : FString();
+                                       case EMetaWeaverValueType::AssetReference:
+                                           return HeaderAssetPath.IsValid() ? *HeaderAssetPath : FString();
+                                       case EMetaWeaverValueType::String:
+                                       default:
+                                           return HeaderText.IsValid() ? HeaderText->GetText().ToString()
+                                                                       : FString();
+                                   }
+                               }();
+                               return IsApplyEnabled(Key, CurrentVal);
+                           })
+                           .OnClicked_Lambda([this,
+                                              Key,
+                                              HeaderText,
+                                              HeaderBool,
+                                              HeaderIntValue,
+                                              HeaderFloatValue,
+                                              HeaderEnumSelected,
+                                              HeaderAssetPath,
+                                              bMixedTypes,
+                                              HeaderType] {
+                               FString NewVal;
+                               if (bMixedTypes)
+                               {
+                                   NewVal = HeaderText.IsValid() ? HeaderText->GetText().ToString() : FString();
+                               }
+                               else
+                               {
+                                   switch (HeaderType)
+                                   {
+                                       case EMetaWeaverValueType::Bool:
+                                           NewVal = HeaderBool.IsValid()
+                                                   && HeaderBool->GetCheckedState() == ECheckBoxState::Checked
+                                               ? TEXT("True")
+                                               : TEXT("False");
+                                           break;
+                                       case EMetaWeaverValueType::Integer:
+                                           NewVal = HeaderIntValue.IsValid()
+                                               ? FMetaWeaverNumericCodec::FormatInteger(*HeaderIntValue)
+                                               : FString();
+                                           break;
+                                       case EMetaWeaverValueType::Float:
+                                           NewVal = HeaderFloatValue.IsValid()
+                                               ? FMetaWeaverNumericCodec::FormatFloat(*HeaderFloatValue)
+                                               : FString();
+                                           break;
+                                       case EMetaWeaverValueType::Enum:
+                                           NewVal =
+                                               HeaderEnumSelected.IsValid() ? *HeaderEnumSelected : FString();
+                                           break;
+                                       case EMetaWeaverValueType::AssetReference:
+                                           NewVal = HeaderAssetPath.IsValid() ? *HeaderAssetPath : FString();
+                                           break;
+                                       case EMetaWeaverValueType::String:
+                                       default:
+                                           NewVal = HeaderText.IsValid() ? HeaderText->GetText().ToString()
+                                                                         : FString();
+                                           break;
+                                   }
+                               }
+                               ApplyColumnValueToAll(Key, NewVal);
+                               return FReply::Handled();
+                           })[SNew(SBox)
+                                  .HAlign(HAlign_Center)
+                                  .VAlign(VAlign_Center)
+                                  .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
+                                      FMetaWeaverStyle::GetCheckBrush())]]]
+                + SHorizontalBox::Slot().AutoWidth().Padding(0.f, 0.f, 2.f, 0.f)
+                      [SNew(SButton)
+                           .ToolTipText(FText::FromString(TEXT("Reset all values to default")))
+                           .IsEnabled_Lambda([this, Key] { return IsResetEnabled(Key); })
+                           .OnClicked_Lambda([this, Key] {
+                               ResetColumnForAll(Key);
+                               return FReply::Handled();
+                           })[SNew(SBox)
+                                  .HAlign(HAlign_Center)
+                                  .VAlign(VAlign_Center)
+                                  .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
+                                      FMetaWeaverStyle::GetResetToDefaultBrush())]]]
+                + SHorizontalBox::Slot()
+                      .AutoWidth()[SNew(SButton)
+                                       .ToolTipText(FText::FromString(TEXT("Remove all")))
+                                       .IsEnabled_Lambda([this, Key] { return IsDeleteEnabled(Key); })
+                                       .OnClicked_Lambda([this, Key] {
+                                           RemoveColumnForAll(Key);
+                                           return FReply::Handled();
+                                       })[SNew(SBox)
+                                              .HAlign(HAlign_Center)
+                                              .VAlign(VAlign_Center)
+                                              .Padding(0.f, 2.f, 0.f, 2.f)[SNew(SImage).Image(
+                                                  FMetaWeaverStyle::GetDeleteBrush())]]]]];
+}
+
 void SMetaWeaverBulkEditor::RebuildCandidateColumnListView()
 {
     ApplyCandidateColumnFilter();
@@ -576,7 +614,7 @@ void SMetaWeaverBulkEditor::GetCellState(const int32 RowIndex,
         return;
     }
     const auto& Per = PerAsset[RowIndex];
-    const bool bSpec = Per.Specs.Contains(Key);
+    const bool bSpec = nullptr != Per.FindSpec(Key);
     if (const auto Found = Per.Tags.Find(Key))
     {
         bOutHasTag = true;
@@ -691,10 +729,9 @@ public:
             }
 
             // Determine spec (type)
-            FMetadataParameterSpec Spec;
-            const bool bHasSpec = PinnedEditor->GetSpecFor(RowIndex, Key, Spec);
+            const auto Spec = PinnedEditor->FindSpecFor(RowIndex, Key);
             // ReSharper disable once CppTooWideScope
-            const auto Type = bHasSpec ? Spec.Type : EMetaWeaverValueType::String;
+            const auto Type = Spec ? Spec->Type : EMetaWeaverValueType::String;
 
             switch (Type)
             {
@@ -729,10 +766,14 @@ public:
                             bool bApp = false, bHas = false;
                             FString Cur;
                             PinnedEditor->GetCellState(RowIndex, Key, bApp, bHas, Cur);
-                            return TOptional(FCString::Atoi64(*Cur));
+                            int64 Parsed{ 0 };
+                            return FMetaWeaverNumericCodec::TryParseInteger(Cur, Parsed) ? TOptional(Parsed)
+                                                                                         : TOptional<int64>();
                         })
                         .OnValueCommitted_Lambda([PinnedEditor, RowIndex, Key](int64 NewVal, ETextCommit::Type) {
-                            PinnedEditor->CommitCellValue(RowIndex, Key, LexToString(NewVal));
+                            PinnedEditor->CommitCellValue(RowIndex,
+                                                          Key,
+                                                          FMetaWeaverNumericCodec::FormatInteger(NewVal));
                         });
                 }
                 case EMetaWeaverValueType::Float:
@@ -747,15 +788,17 @@ public:
                             bool bApp = false, bHas = false;
                             FString Cur;
                             PinnedEditor->GetCellState(RowIndex, Key, bApp, bHas, Cur);
-                            return TOptional(FCString::Atod(*Cur));
+                            double Parsed{ 0.0 };
+                            return FMetaWeaverNumericCodec::TryParseFloat(Cur, Parsed) ? TOptional(Parsed)
+                                                                                       : TOptional<double>();
                         })
                         .OnValueCommitted_Lambda([PinnedEditor, RowIndex, Key](double NewVal, ETextCommit::Type) {
-                            PinnedEditor->CommitCellValue(RowIndex, Key, LexToString(NewVal));
+                            PinnedEditor->CommitCellValue(RowIndex, Key, FMetaWeaverNumericCodec::FormatFloat(NewVal));
                         });
                 }
                 case EMetaWeaverValueType::Enum:
                 {
-                    const auto& Options = PinnedEditor->EnsureEnumOptions(Spec);
+                    const auto& Options = PinnedEditor->EnsureEnumOptions(*Spec);
                     return SNew(SComboBox<TSharedPtr<FString>>)
                         .OptionsSource(&Options)
                         .OnGenerateWidget_Lambda([](const TSharedPtr<FString>& InItem) {
@@ -781,7 +824,7 @@ public:
                 }
                 case EMetaWeaverValueType::AssetReference:
                 {
-                    const auto Allowed = Spec.AllowedClass ? Spec.AllowedClass.Get() : UObject::StaticClass();
+                    const auto Allowed = Spec->AllowedClass ? Spec->AllowedClass.Get() : UObject::StaticClass();
                     return SNew(SObjectPropertyEntryBox)
                         .AllowedClass(Allowed)
                         .AllowClear(true)
@@ -847,7 +890,7 @@ FString SMetaWeaverBulkEditor::DeriveColumnDescription(const FName& Key)
         {
             if (PerAsset.IsValidIndex(Row))
             {
-                if (const auto Spec = PerAsset[Row].Specs.Find(Key))
+                if (const auto Spec = PerAsset[Row].FindSpec(Key))
                 {
                     return Spec->Description;
                 }
@@ -864,7 +907,7 @@ TOptional<EMetaWeaverValueType> SMetaWeaverBulkEditor::DeriveColumnType(const FN
     {
         if (PerAsset.IsValidIndex(Row))
         {
-            if (const auto Spec = PerAsset[Row].Specs.Find(Key))
+            if (const auto Spec = PerAsset[Row].FindSpec(Key))
             {
                 if (!Result.IsSet())
                 {
@@ -890,38 +933,41 @@ const TArray<TSharedPtr<FString>>& SMetaWeaverBulkEditor::BuildHeaderEnumOptions
     TArray<TSharedPtr<FString>>& Options = HeaderEnumOptionsCache.FindOrAdd(Key);
     Options.Reset();
 
-    // The full set will contain all the options that are valid across all the specs for this columns
-    TSet<FString> FullSet;
-    bool bInit = false;
-    for (int32 Row = 0; Row < PerAsset.Num(); ++Row)
+    // Rows of the same class share a spec table, so each distinct membership only needs to be visited once
+    TSet<const FMetaWeaverSpecTable*> VisitedTables;
+    TArray<const FMetaWeaverEnumMembership*> Memberships;
+    for (const auto& Computed : PerAsset)
     {
-        if (PerAsset.IsValidIndex(Row))
+        if (Computed.Specs.IsValid() && !VisitedTables.Contains(Computed.Specs.Get()))
         {
-            if (const auto Spec = PerAsset[Row].Specs.Find(Key))
+            VisitedTables.Add(Computed.Specs.Get());
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Spec = Computed.FindSpec(Key);
+            if (Spec && EMetaWeaverValueType::Enum == Spec->Type)
             {
-                if (EMetaWeaverValueType::Enum == Spec->Type)
-                {
-                    TSet<FString> Local;
-                    for (const auto& V : Spec->EnumValues)
-                    {
-                        Local.Add(V);
-                    }
-                    if (!bInit)
-                    {
-                        FullSet = MoveTemp(Local);
-                        bInit = true;
-                    }
-                    else
-                    {
-                        FullSet = FullSet.Intersect(Local);
-                    }
-                }
+                Memberships.Add(&Computed.Specs->GetEnumMembership(*Spec));
             }
         }
     }
-    if (!FullSet.IsEmpty())
+
+    if (Memberships.Num() > 0)
     {
-        MetaWeaver::UIHelpers::BuildEnumOptionsFromSet(FullSet, Options, /*bSort*/ true);
+        // The options valid across all the specs for this column: probe the smallest list against the others
+        Memberships.Sort([](const auto& A, const auto& B) { return A.Num() < B.Num(); });
+        TArray<FString> Common;
+        for (const auto& Value : Memberships[0]->GetSortedValues())
+        {
+            bool bInAll = true;
+            for (int32 Index = 1; bInAll && Index < Memberships.Num(); ++Index)
+            {
+                bInAll = Memberships[Index]->Contains(Value);
+            }
+            if (bInAll)
+            {
+                Common.Emplace(Value);
+            }
+        }
+        MetaWeaver::UIHelpers::BuildEnumOptions(Common, Options, /*bSort*/ true);
     }
     return Options;
 }
@@ -933,7 +979,7 @@ UClass* SMetaWeaverBulkEditor::DeriveHeaderAllowedClass(const FName& Key) const
     {
         if (PerAsset.IsValidIndex(Row))
         {
-            if (const auto Spec = PerAsset[Row].Specs.Find(Key))
+            if (const auto Spec = PerAsset[Row].FindSpec(Key))
             {
                 if (Spec->Type == EMetaWeaverValueType::AssetReference)
                 {
@@ -987,7 +1033,7 @@ bool SMetaWeaverBulkEditor::IsResetEnabled(const FName Key) const
         {
             if (PerAsset.IsValidIndex(Row))
             {
-                if (const auto Spec = PerAsset[Row].Specs.Find(Key))
+                if (const auto Spec = PerAsset[Row].FindSpec(Key))
                 {
                     // ReSharper disable once CppTooWideScopeInitStatement
                     const auto Value = PerAsset[Row].Tags.Find(Key);
@@ -1013,7 +1059,7 @@ bool SMetaWeaverBulkEditor::IsDeleteEnabled(const FName Key) const
         {
             if (PerAsset.IsValidIndex(Row))
             {
-                const auto Spec = PerAsset[Row].Specs.Find(Key);
+                const auto Spec = PerAsset[Row].FindSpec(Key);
                 // ReSharper disable once CppTooWideScopeInitStatement
                 const auto Value = PerAsset[Row].Tags.Find(Key);
                 if (Value && (!Spec || !Spec->bRequired))
@@ -1026,21 +1072,9 @@ bool SMetaWeaverBulkEditor::IsDeleteEnabled(const FName Key) const
     return false;
 }
 
-bool SMetaWeaverBulkEditor::GetSpecFor(const int32 RowIndex, const FName Key, FMetadataParameterSpec& OutSpec) const
+const FMetadataParameterSpec* SMetaWeaverBulkEditor::FindSpecFor(const int32 RowIndex, const FName Key) const
 {
-    if (RowIndex < 0 || RowIndex >= PerAsset.Num())
-    {
-        return false;
-    }
-    else if (const auto Found = PerAsset[RowIndex].Specs.Find(Key))
-    {
-        OutSpec = *Found;
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    return PerAsset.IsValidIndex(RowIndex) ? PerAsset[RowIndex].FindSpec(Key) : nullptr;
 }
 
 const TArray<TSharedPtr<FString>>& SMetaWeaverBulkEditor::EnsureEnumOptions(const FMetadataParameterSpec& Spec)
@@ -1048,18 +1082,6 @@ const TArray<TSharedPtr<FString>>& SMetaWeaverBulkEditor::EnsureEnumOptions(cons
     return MetaWeaver::UIHelpers::GetOrBuildEnumOptions(EnumOptionsCache, Spec, /*bSort*/ true);
 }
 
-// ReSharper disable once CppMemberFunctionMayBeStatic
-void SMetaWeaverBulkEditor::MarkAssetDirty(const UObject* Asset)
-{
-    if (Asset)
-    {
-        if (const auto Package = Asset->GetOutermost())
-        {
-            Package->SetDirtyFlag(true);
-        }
-    }
-}
-
 void SMetaWeaverBulkEditor::SyncAssetMetaDataState(const int32 RowIndex)
 {
     UpdateAssetItemAtIndex(RowIndex);
@@ -1068,7 +1090,6 @@ void SMetaWeaverBulkEditor::SyncAssetMetaDataState(const int32 RowIndex)
 
 void SMetaWeaverBulkEditor::UpdateAssetMetaDataState(const UObject* Asset, const int32 RowIndex, const FName Key)
 {
-    MarkAssetDirty(Asset);
     ClearCellError(RowIndex, Key);
     UpdateAssetItemAtIndex(RowIndex);
     if (PerAsset.IsValidIndex(RowIndex))
@@ -1080,19 +1101,98 @@ void SMetaWeaverBulkEditor::UpdateAssetMetaDataState(const UObject* Asset, const
     }
 }
 
-void SMetaWeaverBulkEditor::OnDefinitionSetsChanged()
+void SMetaWeaverBulkEditor::OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change)
 {
-    // Specs or defaults changed; clear caches and rebuild matrix & candidates.
-    EnumOptionsCache.Reset();
-    HeaderEnumOptionsCache.Reset();
-    RecomputeCandidateColumnsAndPerAsset();
-    RebuildCandidateColumnListView();
-    RebuildMatrix();
-    ClearAllErrors();
+    if (Change.bAffectsAll)
+    {
+        // Specs or defaults changed; clear caches and rebuild matrix & candidates.
+        EnumOptionsCache.Reset();
+        HeaderEnumOptionsCache.Reset();
+        RecomputeCandidateColumnsAndPerAsset();
+        RebuildCandidateColumnListView();
+        RebuildMatrix();
+        ClearAllErrors();
+    }
+    else
+    {
+        // Only re-gather specs for the rows whose class is affected by the change
+        int32 AffectedRows{ 0 };
+        for (int32 Row = 0; Row < SelectedAssets.Num() && Row < PerAsset.Num(); ++Row)
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Class = SelectedAssets[Row].GetClass();
+            if (!Class || Change.AffectsClass(Class))
+            {
+                UpdatePerAssetData(Row);
+                ClearAllErrorsForRow(Row);
+                ++AffectedRows;
+            }
+        }
+        UE_LOGFMT(LogMetaWeaver,
+                  Verbose,
+                  "Definition sets changed {Keys} keys; refreshing {Rows} of {Total} rows",
+                  Change.AffectedKeys.Num(),
+                  AffectedRows,
+                  SelectedAssets.Num());
+
+        if (AffectedRows > 0)
+        {
+            for (const auto& Key : Change.AffectedKeys)
+            {
+                EnumOptionsCache.Remove(Key);
+            }
+
+            // Candidate keys only change if an affected key appeared in or vanished from the selection
+            bool bCandidatesChanged{ false };
+            for (const auto& Key : Change.AffectedKeys)
+            {
+                const bool bCandidate = CandidateColumns.ContainsByPredicate(
+                    [&Key](const auto& Column) { return Column.IsValid() && Column->Key == Key; });
+                const bool bPresent = PerAsset.ContainsByPredicate([&Key](const FPerAssetComputed& Computed) {
+                    return nullptr != Computed.FindSpec(Key) || Computed.Tags.Contains(Key);
+                });
+                if (bCandidate != bPresent)
+                {
+                    bCandidatesChanged = true;
+                    break;
+                }
+            }
+            if (bCandidatesChanged)
+            {
+                RecomputeCandidateColumns();
+                RebuildCandidateColumnListView();
+            }
+
+            // Rebuild the header of affected pinned columns only; other columns keep their pending header values
+            if (MatrixHeader.IsValid())
+            {
+                const auto FillWidth = GetPinnedColumnFillWidth();
+                for (const auto& Key : PinnedKeys)
+                {
+                    if (Change.AffectsKey(Key))
+                    {
+                        // ReSharper disable once CppTooWideScopeInitStatement
+                        const auto ColumnIndex = MatrixHeader->GetColumns().IndexOfByPredicate(
+                            [&Key](const SHeaderRow::FColumn& Column) { return Column.ColumnId == Key; });
+                        if (INDEX_NONE != ColumnIndex)
+                        {
+                            MatrixHeader->RemoveColumn(Key);
+                            MatrixHeader->InsertColumn(BuildPinnedColumn(Key, FillWidth), ColumnIndex);
+                        }
+                    }
+                }
+            }
+
+            // Regenerates the visible rows only; off-screen rows pick up the new specs when they are generated
+            RefreshListView();
+        }
+    }
 }
 
 void SMetaWeaverBulkEditor::CommitCellValue(const int32 RowIndex, const FName Key, const FString& NewValue)
 {
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkCommit);
+
     if (RowIndex >= 0 && RowIndex < SelectedAssets.Num())
     {
         if (const auto Asset = SelectedAssets[RowIndex].GetAsset())
@@ -1117,14 +1217,17 @@ void SMetaWeaverBulkEditor::CommitCellValue(const int32 RowIndex, const FName Ke
 
 void SMetaWeaverBulkEditor::ApplyColumnValueToAll(const FName Key, const FString& NewValue)
 {
-    TUniquePtr<FScopedTransaction> Tx;
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkCommit);
+
+    TArray<FMetaWeaverMetadataWrite> Writes;
+    TArray<int32> RowIndexes;
     for (int32 RowIndex = 0; RowIndex < SelectedAssets.Num(); ++RowIndex)
     {
         if (const auto Asset = SelectedAssets[RowIndex].GetAsset())
         {
             if (PerAsset.IsValidIndex(RowIndex))
             {
-                const bool bHasSpec = PerAsset[RowIndex].Specs.Contains(Key);
+                const bool bHasSpec = nullptr != PerAsset[RowIndex].FindSpec(Key);
                 // ReSharper disable once CppTooWideScopeInitStatement
                 const bool bHasTag = PerAsset[RowIndex].Tags.Contains(Key);
                 if (bHasSpec || bHasTag)
@@ -1136,20 +1239,22 @@ void SMetaWeaverBulkEditor::ApplyColumnValueToAll(const FName Key, const FString
                     {
                         ClearCellError(RowIndex, Key);
                     }
-                    else
+                    else if (ValidateMetaDataValue(Asset, RowIndex, Key, NewValue))
                     {
-                        if (!Tx.IsValid())
-                        {
-                            Tx = MakeUnique<FScopedTransaction>(
-                                FText::Format(NSLOCTEXT("MetaWeaver", "BulkApplyFmt", "Apply '{0}' to selection"),
-                                              FText::FromName(Key)));
-                        }
-                        ValidateThenSetMetaDataTag(Asset, RowIndex, Key, NewValue);
+                        Writes.Add(FMetaWeaverMetadataWrite::Set(Asset, Key, NewValue));
+                        RowIndexes.Add(RowIndex);
                     }
                 }
             }
         }
     }
+
+    if (Writes.Num() > 0)
+    {
+        const FScopedTransaction Tx(
+            FText::Format(NSLOCTEXT("MetaWeaver", "BulkApplyFmt", "Apply '{0}' to selection"), FText::FromName(Key)));
+        CommitColumnWrites(Writes, RowIndexes);
+    }
 }
 
 void SMetaWeaverBulkEditor::ValidateThenSetMetaDataTag(UObject* Asset,
@@ -1168,14 +1273,17 @@ void SMetaWeaverBulkEditor::ValidateThenSetMetaDataTag(UObject* Asset,
 
 void SMetaWeaverBulkEditor::ResetColumnForAll(const FName Key)
 {
-    TUniquePtr<FScopedTransaction> Tx;
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkCommit);
+
+    TArray<FMetaWeaverMetadataWrite> Writes;
+    TArray<int32> RowIndexes;
     for (int32 RowIndex = 0; RowIndex < SelectedAssets.Num(); ++RowIndex)
     {
         if (const auto Asset = SelectedAssets[RowIndex].GetAsset())
         {
             if (PerAsset.IsValidIndex(RowIndex))
             {
-                if (const auto Spec = PerAsset[RowIndex].Specs.Find(Key))
+                if (const auto Spec = PerAsset[RowIndex].FindSpec(Key))
                 {
                     const auto& DefaultValue = Spec->DefaultValue;
                     // ReSharper disable once CppTooWideScopeInitStatement
@@ -1186,61 +1294,77 @@ void SMetaWeaverBulkEditor::ResetColumnForAll(const FName Key)
                     {
                         ClearCellError(RowIndex, Key);
                     }
-                    else
+                    else if (DefaultValue.IsEmpty())
                     {
-                        if (!Tx.IsValid())
-                        {
-                            Tx = MakeUnique<FScopedTransaction>(
-                                FText::Format(NSLOCTEXT("MetaWeaver", "BulkResetFmt", "Reset '{0}' for selection"),
-                                              FText::FromName(Key)));
-                        }
-                        if (DefaultValue.IsEmpty())
-                        {
-                            if (FMetaWeaverMetadataStore::RemoveMetadataTag(Asset, Key))
-                            {
-                                UpdateAssetMetaDataState(Asset, RowIndex, Key);
-                            }
-                        }
-                        else
-                        {
-                            ValidateThenSetMetaDataTag(Asset, RowIndex, Key, DefaultValue);
-                        }
+                        Writes.Add(FMetaWeaverMetadataWrite::Remove(Asset, Key));
+                        RowIndexes.Add(RowIndex);
+                    }
+                    else if (ValidateMetaDataValue(Asset, RowIndex, Key, DefaultValue))
+                    {
+                        Writes.Add(FMetaWeaverMetadataWrite::Set(Asset, Key, DefaultValue));
+                        RowIndexes.Add(RowIndex);
                     }
                 }
             }
         }
     }
+
+    if (Writes.Num() > 0)
+    {
+        const FScopedTransaction Tx(
+            FText::Format(NSLOCTEXT("MetaWeaver", "BulkResetFmt", "Reset '{0}' for selection"), FText::FromName(Key)));
+        CommitColumnWrites(Writes, RowIndexes);
+    }
 }
 
 void SMetaWeaverBulkEditor::RemoveColumnForAll(const FName Key)
 {
-    TUniquePtr<FScopedTransaction> Tx;
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BulkCommit);
+
+    TArray<FMetaWeaverMetadataWrite> Writes;
+    TArray<int32> RowIndexes;
     for (int32 RowIndex = 0; RowIndex < SelectedAssets.Num(); ++RowIndex)
     {
         // ReSharper disable once CppTooWideScopeInitStatement
         const auto Asset = SelectedAssets[RowIndex].GetAsset();
         if (Asset && PerAsset.IsValidIndex(RowIndex) && Key.IsValid())
         {
-            const auto Spec = PerAsset[RowIndex].Specs.Find(Key);
+            const auto Spec = PerAsset[RowIndex].FindSpec(Key);
             const bool bAdHoc = !Spec || !Spec->bRequired;
             // ReSharper disable once CppTooWideScopeInitStatement
             const bool bHasTag = PerAsset[RowIndex].Tags.Contains(Key);
             if (bAdHoc && bHasTag)
             {
-                // Create transaction before we make changes
-                if (!Tx.IsValid())
-                {
-                    Tx = MakeUnique<FScopedTransaction>(
-                        FText::Format(NSLOCTEXT("MetaWeaver", "BulkRemoveFmt", "Remove '{0}' from selection"),
-                                      FText::FromName(Key)));
-                }
-                if (FMetaWeaverMetadataStore::RemoveMetadataTag(Asset, Key))
-                {
-                    UpdateAssetMetaDataState(Asset, RowIndex, Key);
-                }
+                Writes.Add(FMetaWeaverMetadataWrite::Remove(Asset, Key));
+                RowIndexes.Add(RowIndex);
             }
         }
     }
+
+    if (Writes.Num() > 0)
+    {
+        const FScopedTransaction Tx(
+            FText::Format(NSLOCTEXT("MetaWeaver", "BulkRemoveFmt", "Remove '{0}' from selection"),
+                          FText::FromName(Key)));
+        CommitColumnWrites(Writes, RowIndexes);
+    }
+}
+
+void SMetaWeaverBulkEditor::CommitColumnWrites(const TArray<FMetaWeaverMetadataWrite>& Writes,
+                                               const TArray<int32>& RowIndexes)
+{
+    TArray<EMetaWeaverWriteResult> Results;
+    {
+        TGuardValue CommittingWrites(bCommittingWrites, true);
+        FMetaWeaverMetadataStore::WriteMetadataTags(Writes, Results);
+    }
+    for (int32 Index = 0; Index < Writes.Num(); ++Index)
+    {
+        if (EMetaWeaverWriteResult::Failed != Results[Index])
+        {
+            UpdateAssetMetaDataState(Writes[Index].Asset, RowIndexes[Index], Writes[Index].Key);
+        }
+    }
 }
 
 TArray<int32> SMetaWeaverBulkEditor::GetRowIndexesForAsset(const UObject* Object)
@@ -1260,6 +1384,20 @@ TArray<int32> SMetaWeaverBulkEditor::GetRowIndexesForAsset(const UObject* Object
 }
 
 void SMetaWeaverBulkEditor::OnObjectModified(UObject* Object)
+{
+    RefreshChangedRows(Object);
+}
+
+void SMetaWeaverBulkEditor::OnMetadataChanged(const UPackage* Package)
+{
+    // Our own writes refresh their rows once the whole batch is written
+    if (!bCommittingWrites)
+    {
+        RefreshChangedRows(Package);
+    }
+}
+
+void SMetaWeaverBulkEditor::RefreshChangedRows(const UObject* Object)
 {
     if (Object)
     {
@@ -1284,25 +1422,32 @@ void SMetaWeaverBulkEditor::OnObjectModified(UObject* Object)
             return;
         }
 
+        bool bAnyRowChange = false;
         bool bAnyKeyChange = false;
         for (const int32 RowIndex : AffectedRows)
         {
-            if (const auto Asset = SelectedAssets[RowIndex].GetAsset())
+            // Most modifications are unrelated to metadata; an unchanged stamp means the row is still current
+            const auto Asset = SelectedAssets[RowIndex].GetAsset();
+            if (Asset && FMetaWeaverMetadataStore::GetMetadataStamp(Asset) != PerAsset[RowIndex].Stamp)
             {
-                // Detect key-set changes
-                TArray<FName> OldKeys;
-                PerAsset[RowIndex].Tags.GenerateKeyArray(OldKeys);
-                TArray<FName> NewKeys;
+                // Detect key-set changes by reading the latest metadata in place. Equal sizes and every latest key
+                // being known means the key sets are equal.
+                const auto& OldTags = PerAsset[RowIndex].Tags;
+                const auto LatestTags = FMetaWeaverMetadataStore::FindMetadataTags(Asset);
+                bool bKeysDifferForRow = OldTags.Num() != (LatestTags ? LatestTags->Num() : 0);
+                if (!bKeysDifferForRow && LatestTags)
                 {
-                    TMap<FName, FString> LatestTags;
-                    FMetaWeaverMetadataStore::ListMetadataTags(Asset, LatestTags);
-                    LatestTags.GenerateKeyArray(NewKeys);
+                    for (const auto& Pair : *LatestTags)
+                    {
+                        if (!OldTags.Contains(Pair.Key))
+                        {
+                            bKeysDifferForRow = true;
+                            break;
+                        }
+                    }
                 }
-                const TSet OldSet(OldKeys);
-                const TSet NewSet(NewKeys);
-                const bool bKeysDifferForRow = OldSet.Num() != NewSet.Num() || !OldSet.Difference(NewSet).IsEmpty()
-                    || !NewSet.Difference(OldSet).IsEmpty();
 
+                bAnyRowChange = true;
                 bAnyKeyChange |= bKeysDifferForRow;
                 SyncAssetMetaDataState(RowIndex);
             }
@@ -1315,7 +1460,10 @@ void SMetaWeaverBulkEditor::OnObjectModified(UObject* Object)
             RebuildMatrix();
         }
 
-        RefreshListView();
+        if (bAnyRowChange)
+        {
+            RefreshListView();
+        }
     }
 }
 
@@ -1419,15 +1567,12 @@ void SMetaWeaverBulkEditor::UpdatePerAssetData(const int32 RowIndex)
     check(SelectedAssets.IsValidIndex(RowIndex));
     check(PerAsset.IsValidIndex(RowIndex));
 
+    INC_DWORD_STAT(STAT_MetaWeaver_RowsProcessed);
     if (const auto Asset = SelectedAssets[RowIndex].GetAsset())
     {
-        TArray<FMetadataParameterSpec> Specs;
-        FMetaWeaverMetadataStore::GatherSpecsForClass(Asset->GetClass(), Specs);
-        for (const auto& Spec : Specs)
-        {
-            PerAsset[RowIndex].Specs.Add(Spec.Key, Spec);
-        }
+        PerAsset[RowIndex].Specs = FMetaWeaverMetadataStore::GetSpecTableForClass(Asset->GetClass());
         FMetaWeaverMetadataStore::ListMetadataTags(Asset, PerAsset[RowIndex].Tags);
+        PerAsset[RowIndex].Stamp = FMetaWeaverMetadataStore::GetMetadataStamp(Asset);
     }
 }
 
@@ -1513,11 +1658,11 @@ bool SMetaWeaverBulkEditor::ValidateMetaDataValue(const UObject* Asset,
         if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
         {
             // ReSharper disable once CppTooWideScopeInitStatement
-            const auto Report = Subsystem->ValidateKeyValue(Asset->GetClass(), Key, Value);
+            const auto Report = Subsystem->ValidateAssetKeyValue(Asset, Key, Value);
             if (Report.bHasErrors)
             {
                 const auto Message =
-                    Report.Issues.Num() > 0 ? Report.Issues[0].Message : FText::FromString(TEXT("Invalid value"));
+                    Report.Issues.Num() > 0 ? Report.Issues[0].GetMessage() : FText::FromString(TEXT("Invalid value"));
                 SetCellError(RowIndex, Key, Message);
                 return false;
             }
@@ -16,7 +16,10 @@
 #include "AssetRegistry/AssetData.h"
 #include "CoreMinimal.h"
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SHeaderRow.h"
 
 class SSearchBox;
 class ITableRow;
@@ -24,6 +27,7 @@ class STableViewBase;
 template <typename ItemType>
 class SListView;
 class SMetaWeaverBulkRow;
+struct FMetaWeaverDefinitionSetsChange;
 
 /**
  * The bulk metadata editor.
@@ -43,11 +47,10 @@ public:
     void GetCellState(int32 RowIndex, FName Key, bool& bOutApplicable, bool& bOutHasTag, FString& OutValue) const;
     // Editing helpers (used by row/cell editors)
     void CommitCellValue(int32 RowIndex, FName Key, const FString& NewValue);
-    bool GetSpecFor(int32 RowIndex, FName Key, FMetadataParameterSpec& OutSpec) const;
+    // The returned spec is owned by the row's shared spec table and stays valid until the row is next updated
+    const FMetadataParameterSpec* FindSpecFor(int32 RowIndex, FName Key) const;
     const TArray<TSharedPtr<FString>>& EnsureEnumOptions(const FMetadataParameterSpec& Spec);
 
-    static void MarkAssetDirty(const UObject* Asset);
-
     /**
      * Asset at RowIndex has been changed. Make sure we rebuild relevant caches and reset errors.
      *
@@ -70,6 +73,8 @@ public:
     void ValidateThenSetMetaDataTag(UObject* Asset, int32 RowIndex, FName Key, const FString& Value);
     void ResetColumnForAll(FName Key);
     void RemoveColumnForAll(FName Key);
+    // Apply the edits of a column operation as one batch write. RowIndexes is parallel to Writes.
+    void CommitColumnWrites(const TArray<FMetaWeaverMetadataWrite>& Writes, const TArray<int32>& RowIndexes);
 
 private:
     friend class SMetaWeaverBulkRow;
@@ -78,8 +83,14 @@ private:
     // Per-asset computed state
     struct FPerAssetComputed
     {
-        TMap<FName, FMetadataParameterSpec> Specs; // effective specs per key
-        TMap<FName, FString> Tags;                 // current tags per key
+        FMetaWeaverSpecTablePtr Specs;  // effective specs, shared by every asset of the same class
+        TMap<FName, FString> Tags;      // current tags per key
+        FMetaWeaverMetadataStamp Stamp; // version of the package metadata the tags were read from
+
+        const FMetadataParameterSpec* FindSpec(const FName Key) const
+        {
+            return Specs.IsValid() ? Specs->Find(Key) : nullptr;
+        }
     };
 
 // UI state for which metadata keys are available and pinned
@@ -102,12 +113,15 @@ private:
 
     // Matrix (rows = assets, columns = pinned keys)
     TSharedPtr<SListView<TSharedPtr<FAssetData>>> ListView;
+    TSharedPtr<SHeaderRow> MatrixHeader;
     TSharedPtr<SBox> MatrixContainer;
     TSharedPtr<SSearchBox> KeySearchBox;
     TArray<TSharedPtr<FAssetData>> AssetItems; // backing store for asset rows
     TArray<FPerAssetComputed> PerAsset;        // parallel to SelectedAssets
     TMap<FName, TArray<TSharedPtr<FString>>> EnumOptionsCache;
     bool bLockToSelection{ false };
+    // Set while the editor writes a batch, so the store's change events do not refresh rows twice
+    bool bCommittingWrites{ false };
 
 #pragma region Cell Error Handlers
     // Inline cell error feedback storage: RowIndex -> Key -> Message
@@ -130,7 +144,10 @@ private:
     // Build and update helpers
     void BuildUI();
     void RecomputeCandidateColumnsAndPerAsset();
+    void RecomputeCandidateColumns();
     void RebuildMatrix();
+    float GetPinnedColumnFillWidth() const;
+    SHeaderRow::FColumn::FArguments BuildPinnedColumn(const FName& Key, float FillWidth);
     TSharedRef<ITableRow> OnGenerateAssetRow(TSharedPtr<FAssetData> Item, const TSharedRef<STableViewBase>& OwnerTable);
 
     FString DeriveColumnDescription(const FName& Key);
@@ -149,6 +166,7 @@ private:
 
 #pragma region Event handlers
     FDelegateHandle ObjectModifiedHandle;
+    FDelegateHandle MetadataChangedHandle;
     FDelegateHandle AssetRemovedHandle;
     FDelegateHandle AssetRenamedHandle;
     FDelegateHandle AssetUpdatedHandle;
@@ -156,10 +174,12 @@ private:
     FDelegateHandle DefinitionSetsChangedHandle;
 
     void OnObjectModified(UObject* Object);
+    void OnMetadataChanged(const UPackage* Package);
+    void RefreshChangedRows(const UObject* Object);
     void OnAssetRegistryAssetRemoved(const FAssetData& RemovedAsset);
     void OnAssetRegistryAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
     void OnAssetRegistryAssetUpdated(const FAssetData& UpdatedAsset);
     void OnContentBrowserAssetSelectionChanged(const TArray<FAssetData>& NewSelectedAssets, bool bIsPrimaryBrowser);
-    void OnDefinitionSetsChanged();
+    void OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change);
 #pragma endregion
 };
@@ -18,6 +18,7 @@
 #include "IContentBrowserSingleton.h"
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
 #include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverNumericCodec.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
 #include "MetaWeaverEditorSettings.h"
@@ -112,7 +113,7 @@ private:
         return SNew(SHorizontalBox)
             + SHorizontalBox::Slot().AutoWidth().VAlign(
                 VAlign_Center)[SNew(STextBlock).Text(FText::FromName(Item->Key)).ToolTipText_Lambda([Item = Item] {
-                  return FText::FromString(Item.IsValid() ? Item->Spec.Description : FString());
+                  return FText::FromString(Item.IsValid() ? Item->GetSpec().Description : FString());
               })]
             + SHorizontalBox::Slot().AutoWidth().Padding(4.f, 0.f).VAlign(
                 VAlign_Center)[SNew(STextBlock)
@@ -132,7 +133,7 @@ private:
 
         // Build the same value widget used previously
         TSharedRef<SWidget> ValueWidget = SNew(STextBlock).Text(FText::FromString(Item->Value));
-        switch (Item->Spec.Type)
+        switch (Item->GetSpec().Type)
         {
             case EMetaWeaverValueType::Bool:
             {
@@ -154,12 +155,13 @@ private:
                                       int64 Parsed{ 0 };
                                       if (Item.IsValid())
                                       {
-                                          LexTryParseString(Parsed, *Item->Value);
+                                          FMetaWeaverNumericCodec::TryParseInteger(Item->Value, Parsed);
                                       }
                                       return Parsed;
                                   })
-                                  .OnValueCommitted_Lambda([Pinned, Item = Item](const auto NewValue, auto) {
-                                      Pinned->OnEditMetadataTag(*Item, LexToString(NewValue));
+                                  .OnValueCommitted_Lambda([Pinned, Item = Item](const int64 NewValue, auto) {
+                                      Pinned->OnEditMetadataTag(*Item,
+                                                                FMetaWeaverNumericCodec::FormatInteger(NewValue));
                                   });
                 break;
             }
@@ -171,12 +173,12 @@ private:
                                       double Parsed{ 0.0 };
                                       if (Item.IsValid())
                                       {
-                                          LexTryParseString(Parsed, *Item->Value);
+                                          FMetaWeaverNumericCodec::TryParseFloat(Item->Value, Parsed);
                                       }
                                       return Parsed;
                                   })
-                                  .OnValueCommitted_Lambda([Pinned, Item = Item](const auto NewValue, auto) {
-                                      Pinned->OnEditMetadataTag(*Item, LexToString(NewValue));
+                                  .OnValueCommitted_Lambda([Pinned, Item = Item](const double NewValue, auto) {
+                                      Pinned->OnEditMetadataTag(*Item, FMetaWeaverNumericCodec::FormatFloat(NewValue));
                                   });
                 break;
             }
@@ -215,7 +217,8 @@ private:
             }
             case EMetaWeaverValueType::AssetReference:
             {
-                const auto Allowed = Item->Spec.AllowedClass ? Item->Spec.AllowedClass.Get() : UObject::StaticClass();
+                const auto& AllowedClass = Item->GetSpec().AllowedClass;
+                const auto Allowed = AllowedClass ? AllowedClass.Get() : UObject::StaticClass();
                 ValueWidget = SNew(SObjectPropertyEntryBox)
                                   .AllowedClass(Allowed)
                                   .AllowClear(true)
@@ -267,7 +270,7 @@ private:
         auto Pinned = Editor.Pin();
         check(Item.IsValid() && Pinned.IsValid());
 
-        if (!Item->Spec.Key.IsNone())
+        if (!Item->GetSpec().Key.IsNone())
         {
             return SNew(SHorizontalBox)
                 + SHorizontalBox::Slot()
@@ -278,7 +281,7 @@ private:
                                        .VAlign(VAlign_Center)
                                        .ContentPadding(0)
                                        .IsEnabled_Lambda([Item = Item] {
-                                           const auto& DefaultVal = Item->Spec.DefaultValue;
+                                           const auto& DefaultVal = Item->GetSpec().DefaultValue;
                                            // Disable if current value exists and matches the
                                            // default
                                            return DefaultVal.IsEmpty()
@@ -306,8 +309,8 @@ private:
         check(Item.IsValid() && Pinned.IsValid());
 
         // ReSharper disable once CppTooWideScopeInitStatement
-        const bool bAdHocTag = Item->Spec.Key.IsNone();
-        if (bAdHocTag || !Item->Spec.bRequired)
+        const bool bAdHocTag = Item->GetSpec().Key.IsNone();
+        if (bAdHocTag || !Item->GetSpec().bRequired)
         {
             const auto Tooltip =
                 bAdHocTag ? TEXT("Delete this metadata key") : TEXT("Remove this value from the asset");
@@ -344,6 +347,10 @@ SMetaWeaverEditor::~SMetaWeaverEditor()
     {
         FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
     }
+    if (MetadataChangedHandle.IsValid())
+    {
+        FMetaWeaverMetadataStore::OnMetadataChanged().Remove(MetadataChangedHandle);
+    }
     if (ContentBrowserSelectionHandle.IsValid())
     {
         if (const auto Module = FModuleManager::Get().GetModulePtr<FContentBrowserModule>(TEXT("ContentBrowser")))
@@ -386,11 +393,17 @@ SMetaWeaverEditor::~SMetaWeaverEditor()
 
 bool FTagItem::IsUnsaved() const
 {
-    const bool bDefined = !Spec.Key.IsNone();
-    const bool bHasDefault = bDefined && !Spec.DefaultValue.IsEmpty();
+    const bool bDefined = nullptr != Spec && !Spec->Key.IsNone();
+    const bool bHasDefault = bDefined && !Spec->DefaultValue.IsEmpty();
     return bHasDefault && !bHasTag;
 }
 
+const FMetadataParameterSpec& FTagItem::GetSpec() const
+{
+    static const FMetadataParameterSpec AdHocSpec;
+    return Spec ? *Spec : AdHocSpec;
+}
+
 void SMetaWeaverEditor::Construct(const FArguments& InArgs)
 {
     SelectedAssets = InArgs._SelectedAssets;
@@ -468,6 +481,8 @@ void SMetaWeaverEditor::Construct(const FArguments& InArgs)
 
     // External change notifications
     ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddSP(this, &SMetaWeaverEditor::OnObjectModified);
+    MetadataChangedHandle =
+        FMetaWeaverMetadataStore::OnMetadataChanged().AddSP(this, &SMetaWeaverEditor::OnMetadataChanged);
 
     // Content Browser selection change (primary browser only)
     {
@@ -517,7 +532,6 @@ void SMetaWeaverEditor::OnAddMetadataTag()
                 // ReSharper disable once CppTooWideScopeInitStatement
                 if (FMetaWeaverMetadataStore::SetMetadataTag(Asset, FName(*KeyStr), NewValueText->GetText().ToString()))
                 {
-                    MarkAssetDirty(Asset);
                     RebuildTagListItems();
                     SaveAnyUnsavedDefaults();
                     ClearAddFields();
@@ -590,14 +604,13 @@ void SMetaWeaverEditor::OnResetMetadataTag(FTagItem& Item)
 {
     if (const auto Asset = GetFirstAssetForUI())
     {
-        const auto& DefaultVal = Item.Spec.DefaultValue;
+        const auto& DefaultVal = Item.GetSpec().DefaultValue;
         const bool bRemove = DefaultVal.IsEmpty();
         FScopedTransaction Transaction((NSLOCTEXT("MetaWeaver", "ResetTagTransaction", "Reset Metadata Tag")));
         const bool bOk = bRemove ? FMetaWeaverMetadataStore::RemoveMetadataTag(Asset, Item.Key)
                                  : FMetaWeaverMetadataStore::SetMetadataTag(Asset, Item.Key, DefaultVal);
         if (bOk)
         {
-            MarkAssetDirty(Asset);
             Item.Value = DefaultVal;
             Item.bHasTag = !DefaultVal.IsEmpty();
             RebuildTagListUI();
@@ -607,43 +620,31 @@ void SMetaWeaverEditor::OnResetMetadataTag(FTagItem& Item)
     }
 }
 
-// ReSharper disable once CppMemberFunctionMayBeStatic
-void SMetaWeaverEditor::MarkAssetDirty(const UObject* Asset)
-{
-    if (Asset)
-    {
-        if (const auto Package = Asset->GetOutermost())
-        {
-            Package->SetDirtyFlag(true);
-        }
-    }
-}
-
 void SMetaWeaverEditor::SaveAnyUnsavedDefaults(TOptional<FName> ExcludeKey)
 {
     if (const auto Asset = ResolveFirstAsset())
     {
-        TMap<FName, FString> Pending;
+        // Every pending default is written by one batch, so the asset is modified once rather than once per key
+        TArray<FMetaWeaverMetadataWrite> Writes;
+        TArray<FTagItem*> WrittenItems;
         for (const auto& It : TagItems)
         {
             if (It.IsValid() && It->IsUnsaved() && (!ExcludeKey.IsSet() || It->Key != ExcludeKey.GetValue()))
             {
-                Pending.Add(It->Key, It->Spec.DefaultValue);
+                Writes.Add(FMetaWeaverMetadataWrite::Set(Asset, It->Key, It->GetSpec().DefaultValue));
+                WrittenItems.Add(It.Get());
             }
         }
-        if (Pending.Num() > 0)
+        if (Writes.Num() > 0)
         {
-            for (const auto& Pair : Pending)
+            TArray<EMetaWeaverWriteResult> Results;
+            FMetaWeaverMetadataStore::WriteMetadataTags(Writes, Results);
+            for (int32 Index = 0; Index < Writes.Num(); ++Index)
             {
-                FMetaWeaverMetadataStore::SetMetadataTag(Asset, Pair.Key, Pair.Value);
-            }
-            MarkAssetDirty(Asset);
-            for (const auto& It : TagItems)
-            {
-                if (It.IsValid() && Pending.Contains(It->Key))
+                if (EMetaWeaverWriteResult::Failed != Results[Index])
                 {
-                    It->bHasTag = true;
-                    It->Value = It->Spec.DefaultValue;
+                    WrittenItems[Index]->bHasTag = true;
+                    WrittenItems[Index]->Value = WrittenItems[Index]->GetSpec().DefaultValue;
                 }
             }
             RevalidateUI();
@@ -662,7 +663,7 @@ void SMetaWeaverEditor::OnEditMetadataTag(FTagItem& Item, const FString& NewValu
             if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
             {
                 // ReSharper disable once CppTooWideScopeInitStatement
-                const auto Report = Subsystem->ValidateKeyValue(Asset->GetClass(), Item.Key, NewValue);
+                const auto Report = Subsystem->ValidateAssetKeyValue(Asset, Item.Key, NewValue);
                 if (Report.bHasErrors)
                 {
                     // Surface the first error inline on this row and abort the write
@@ -671,13 +672,13 @@ void SMetaWeaverEditor::OnEditMetadataTag(FTagItem& Item, const FString& NewValu
                     {
                         if (Issue.Key == Item.Key && Issue.Severity == EMetaWeaverIssueSeverity::Error)
                         {
-                            Message = Issue.Message.ToString();
+                            Message = Issue.GetMessage().ToString();
                             break;
                         }
                     }
                     if (Message.IsEmpty() && Report.Issues.Num() > 0)
                     {
-                        Message = Report.Issues[0].Message.ToString();
+                        Message = Report.Issues[0].GetMessage().ToString();
                     }
                     Item.Severity = EMetaWeaverIssueSeverity::Error;
                     Item.ValidationMessage = MoveTemp(Message);
@@ -691,7 +692,6 @@ void SMetaWeaverEditor::OnEditMetadataTag(FTagItem& Item, const FString& NewValu
         FScopedTransaction Tx(NSLOCTEXT("MetaWeaver", "EditTagTransaction", "Edit Metadata Tag"));
         if (FMetaWeaverMetadataStore::SetMetadataTag(Asset, Item.Key, NewVal))
         {
-            MarkAssetDirty(Asset);
             Item.Value = NewVal;
             Item.bHasTag = true;
             RevalidateUI();
@@ -708,7 +708,6 @@ void SMetaWeaverEditor::OnRemoveMetadataTag(const FTagItem& Item)
         FScopedTransaction Tx(NSLOCTEXT("MetaWeaver", "DeleteTagTransaction", "Delete Metadata Tag"));
         if (FMetaWeaverMetadataStore::RemoveMetadataTag(Asset, Item.Key))
         {
-            MarkAssetDirty(Asset);
             RebuildTagListUI();
             RefreshListUI();
             SaveAnyUnsavedDefaults(Item.Key);
@@ -857,6 +856,16 @@ void SMetaWeaverEditor::OnObjectModified(UObject* Object)
     }
 }
 
+void SMetaWeaverEditor::OnMetadataChanged(const UPackage* Package)
+{
+    // Sidecar writes and their undo modify no object, so they are only seen through the store
+    if (Package && SelectedAssets.Num() > 0 && SelectedAssets[0].PackageName == Package->GetFName())
+    {
+        bPendingExternalRefresh = true;
+        NextExternalRefreshTime = FPlatformTime::Seconds() + 0.15;
+    }
+}
+
 FText SMetaWeaverEditor::BuildSelectionSummaryText() const
 {
     switch (CurrentViewState)
@@ -1010,8 +1019,7 @@ void SMetaWeaverEditor::RebuildTagListItems()
     if (const auto Asset = ResolveFirstAsset())
     {
         // Effective specs for this asset's class
-        TArray<FMetadataParameterSpec> Specs;
-        FMetaWeaverMetadataStore::GatherSpecsForClass(Asset->GetClass(), Specs);
+        const auto SpecTable = FMetaWeaverMetadataStore::GetSpecTableForClass(Asset->GetClass());
 
         // Current tags on asset
         TMap<FName, FString> Tags;
@@ -1023,11 +1031,12 @@ void SMetaWeaverEditor::RebuildTagListItems()
         }
 
         // Rows from specs (defined keys)
-        for (const auto& Spec : Specs)
+        for (const auto& Spec : SpecTable->GetSpecs())
         {
             auto Item = MakeShared<FTagItem>();
             Item->Key = Spec.Key;
-            Item->Spec = Spec;
+            Item->SpecTable = SpecTable;
+            Item->Spec = &Spec;
             if (!Spec.Key.IsNone())
             {
                 DefinedKeys.Add(Spec.Key);
@@ -1049,7 +1058,7 @@ void SMetaWeaverEditor::RebuildTagListItems()
         for (const auto& Pair : Tags)
         {
             const auto& K = Pair.Key;
-            if (!Specs.ContainsByPredicate([&](const auto& S) { return S.Key == K; }))
+            if (!SpecTable->Contains(K))
             {
                 auto Item = MakeShared<FTagItem>();
                 Item->Key = K;
@@ -1112,7 +1121,7 @@ void SMetaWeaverEditor::RefreshValidation()
                                 && Item->Severity.GetValue() == EMetaWeaverIssueSeverity::Info))
                         {
                             Item->Severity = Issue.Severity;
-                            Item->ValidationMessage = Issue.Message.ToString();
+                            Item->ValidationMessage = Issue.GetMessage().ToString();
                         }
                         break;
                     }
@@ -1130,11 +1139,16 @@ void SMetaWeaverEditor::RefreshValidation()
     }
 }
 
-void SMetaWeaverEditor::OnDefinitionSetsChanged()
+void SMetaWeaverEditor::OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change)
 {
-    // Definition changes affect specs and default values; rebuild and refresh
-    RebuildTagListItems();
-    RefreshListView();
+    // ReSharper disable once CppTooWideScopeInitStatement
+    const auto Asset = ResolveFirstAsset();
+    if (!Asset || Change.AffectsClass(Asset->GetClass()))
+    {
+        // Definition changes affect specs and default values; rebuild and refresh
+        RebuildTagListItems();
+        RefreshListView();
+    }
 }
 
 // ReSharper disable once CppPassValueParameterByConstReference
@@ -16,6 +16,7 @@
 #include "AssetRegistry/AssetData.h"
 #include "CoreMinimal.h"
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
 #include "Widgets/Input/SSearchBox.h"
 #include "Widgets/SCompoundWidget.h"
@@ -31,7 +32,11 @@ struct FTagItem
 {
     FName Key;
     FString Value;
-    FMetadataParameterSpec Spec;
+
+    // Shared spec table of the asset's class. Keeps Spec alive; unset for tags not covered by the definitions.
+    FMetaWeaverSpecTablePtr SpecTable;
+    const FMetadataParameterSpec* Spec{ nullptr };
+
     // Persistent options for enum editors. SComboBox requires OptionsSource to
     // outlive the widget so can NOT build a temporary array in OnGenerateRow.
     // Only populated when Spec.Type == Enum.
@@ -45,6 +50,9 @@ struct FTagItem
     FString ValidationMessage;
 
     bool IsUnsaved() const;
+
+    // The spec for the key, or a default spec (with Key == None) for ad-hoc tags.
+    const FMetadataParameterSpec& GetSpec() const;
 };
 
 /**
@@ -87,7 +95,6 @@ private:
 
     // Save any other keys that have defaults defined but are not yet saved on the asset.
     void SaveAnyUnsavedDefaults(TOptional<FName> ExcludeKey = TOptional<FName>());
-    void MarkAssetDirty(const UObject* Asset);
 
     // Methods that perform actions on metadata tags
     void OnAddMetadataTag();
@@ -103,6 +110,7 @@ private:
     void OnAssetRegistryAssetRemoved(const FAssetData& RemovedAsset);
     void OnAssetRegistryAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
     void OnObjectModified(UObject* Object);
+    void OnMetadataChanged(const UPackage* Package);
     FText BuildSelectionSummaryText() const;
     FText BuildSelectionMessageText() const;
     TSharedRef<SWidget> BuildTopBar();
@@ -141,6 +149,7 @@ private:
     bool bPendingExternalRefresh{ false };
     double NextExternalRefreshTime{ -1.0 };
     FDelegateHandle ObjectModifiedHandle;
+    FDelegateHandle MetadataChangedHandle;
     FDelegateHandle ContentBrowserSelectionHandle;
     FDelegateHandle AssetRemovedHandle;
     FDelegateHandle AssetRenamedHandle;
@@ -148,5 +157,5 @@ private:
 
     friend class SMetaWeaverRow;
 
-    void OnDefinitionSetsChanged();
+    void OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change);
 };
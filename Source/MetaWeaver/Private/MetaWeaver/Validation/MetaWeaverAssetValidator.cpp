@@ -37,13 +37,7 @@ EDataValidationResult UMetaWeaverAssetValidator::ValidateLoadedAsset_Implementat
                                                                                     UObject* InAsset,
                                                                                     FDataValidationContext& Context)
 {
-    UObject* AssetToValidate = InAsset;
-    if (!AssetToValidate && InAssetData.IsValid())
-    {
-        AssetToValidate = InAssetData.GetAsset();
-    }
-
-    if (!AssetToValidate || !GEditor)
+    if ((!InAsset && !InAssetData.IsValid()) || !GEditor)
     {
         return EDataValidationResult::NotValidated;
     }
@@ -51,16 +45,18 @@ EDataValidationResult UMetaWeaverAssetValidator::ValidateLoadedAsset_Implementat
     {
         if (const auto Subsystem = GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>())
         {
-            const auto Report = Subsystem->ValidateAsset(AssetToValidate);
+            // Validate unloaded assets from their asset registry tags rather than loading every asset touched
+            const auto Report =
+                InAsset ? Subsystem->ValidateAsset(InAsset) : Subsystem->ValidateAssetData({ InAssetData }).Reports[0];
             auto bHasErrors = Report.bHasErrors;
 
             for (const auto& Issue : Report.Issues)
             {
                 const auto Message = Issue.Key.IsNone()
-                    ? Issue.Message
+                    ? Issue.GetMessage()
                     : FText::Format(LOCTEXT("MetaWeaverIssueWithKey", "Metadata '{0}': {1}"),
                                     FText::FromName(Issue.Key),
-                                    Issue.Message);
+                                    Issue.GetMessage());
                 if (EMetaWeaverIssueSeverity::Error == Issue.Severity)
                 {
                     Context.AddError(Message);
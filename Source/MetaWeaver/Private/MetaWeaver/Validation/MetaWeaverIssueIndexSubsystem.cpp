@@ -0,0 +1,365 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverIssueIndexSubsystem.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "MetaWeaver/MetaWeaverEditorSettings.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
+#include "Misc/PackageName.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverIssueIndexSubsystem)
+
+namespace
+{
+    // Assets validated per call into the validation subsystem. Small enough that a slice fits well within the frame
+    // budget, large enough that the parallel checks of the batch are worth dispatching.
+    constexpr int32 SliceSize = 32;
+
+    const FName GameContentPath(TEXT("/Game"));
+
+    // Severities are ordered from most to least severe
+    bool HasIssueOfSeverity(const FMetaWeaverValidationReport& Report, const EMetaWeaverIssueSeverity MinSeverity)
+    {
+        return Report.Issues.ContainsByPredicate(
+            [MinSeverity](const FMetaWeaverIssue& Issue) { return Issue.Severity <= MinSeverity; });
+    }
+} // namespace
+
+bool UMetaWeaverIssueIndexSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Commandlets validate explicitly and would only pay for a sweep they never query
+    return !IsRunningCommandlet() && GetDefault<UMetaWeaverEditorSettings>()->bEnableIssueIndex
+        && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMetaWeaverIssueIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    ValidationSubsystem = Collection.InitializeDependency<UMetaWeaverValidationSubsystem>();
+    DefinitionSetsChangedHandle = ValidationSubsystem->GetOnDefinitionSetsChanged().AddUObject(
+        this,
+        &UMetaWeaverIssueIndexSubsystem::OnDefinitionSetsChanged);
+
+    ObjectModifiedHandle =
+        FCoreUObjectDelegates::OnObjectModified.AddUObject(this, &UMetaWeaverIssueIndexSubsystem::OnObjectModified);
+    PackageSavedHandle =
+        UPackage::PackageSavedWithContextEvent.AddUObject(this, &UMetaWeaverIssueIndexSubsystem::OnPackageSaved);
+    // Sidecar writes modify no object, so they are only seen through the store
+    MetadataChangedHandle = FMetaWeaverMetadataStore::OnMetadataChanged().AddUObject(
+        this,
+        &UMetaWeaverIssueIndexSubsystem::OnMetadataChanged);
+
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    AssetRemovedHandle =
+        AssetRegistry.OnAssetRemoved().AddUObject(this, &UMetaWeaverIssueIndexSubsystem::OnAssetRemoved);
+    AssetRenamedHandle =
+        AssetRegistry.OnAssetRenamed().AddUObject(this, &UMetaWeaverIssueIndexSubsystem::OnAssetRenamed);
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateUObject(this, &UMetaWeaverIssueIndexSubsystem::Tick));
+}
+
+void UMetaWeaverIssueIndexSubsystem::Deinitialize()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+    TickerHandle.Reset();
+
+    FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+    UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+    FMetaWeaverMetadataStore::OnMetadataChanged().Remove(MetadataChangedHandle);
+    if (const auto AssetRegistry = IAssetRegistry::Get())
+    {
+        AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
+    if (ValidationSubsystem)
+    {
+        ValidationSubsystem->GetOnDefinitionSetsChanged().Remove(DefinitionSetsChangedHandle);
+        ValidationSubsystem = nullptr;
+    }
+
+    ReportsByPackage.Empty();
+    DirtyPackages.Empty();
+    SweepQueue.Empty();
+    SweepQueued.Empty();
+
+    Super::Deinitialize();
+}
+
+TArray<FMetaWeaverValidationReport>
+UMetaWeaverIssueIndexSubsystem::GetFailingAssets(const EMetaWeaverIssueSeverity MinSeverity) const
+{
+    TArray<FMetaWeaverValidationReport> Failing;
+    for (const auto& PackageAndReports : ReportsByPackage)
+    {
+        for (const auto& Report : PackageAndReports.Value)
+        {
+            if (HasIssueOfSeverity(Report, MinSeverity))
+            {
+                Failing.Add(Report);
+            }
+        }
+    }
+    return Failing;
+}
+
+bool UMetaWeaverIssueIndexSubsystem::FindReport(const FSoftObjectPath& Asset,
+                                                FMetaWeaverValidationReport& OutReport) const
+{
+    if (const auto Reports = ReportsByPackage.Find(Asset.GetLongPackageFName()))
+    {
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Found = Reports->FindByPredicate(
+            [&Asset](const FMetaWeaverValidationReport& Report) { return Asset == Report.Asset; });
+        if (Found)
+        {
+            OutReport = *Found;
+            return true;
+        }
+    }
+    return false;
+}
+
+int32 UMetaWeaverIssueIndexSubsystem::GetNumPending() const
+{
+    return DirtyPackages.Num() + SweepQueue.Num() - SweepCursor;
+}
+
+bool UMetaWeaverIssueIndexSubsystem::Tick(float)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_IssueIndexTick);
+
+    // Validating before the definitions are compiled would block the editor until they are
+    if (!ValidationSubsystem || !ValidationSubsystem->AreDefinitionSetsReady())
+    {
+        return true;
+    }
+
+    if (bFullSweepRequested && !IAssetRegistry::GetChecked().IsLoadingAssets())
+    {
+        bFullSweepRequested = false;
+        QueueSweep(nullptr);
+    }
+
+    const auto BudgetSeconds = GetDefault<UMetaWeaverEditorSettings>()->IssueIndexFrameBudgetMs / 1000.0;
+    const auto EndTime = FPlatformTime::Seconds() + BudgetSeconds;
+
+    // The uniqueness index is rebuilt after every definition change. Build it within the budget before validating,
+    // as the first slice with a unique key would otherwise build it in one go.
+    if (!ValidationSubsystem->BuildUniquenessIndex(EndTime))
+    {
+        return true;
+    }
+
+    auto bChanged{ false };
+    TArray<FAssetData> Slice;
+    do
+    {
+        Slice.Reset();
+
+        // Saved and modified packages go first so edits are reflected promptly. Their reports are replaced as a whole
+        // so assets that were deleted or renamed within the package drop out of the index.
+        while (DirtyPackages.Num() > 0 && Slice.Num() < SliceSize)
+        {
+            auto It = DirtyPackages.CreateIterator();
+            const auto PackageName = *It;
+            It.RemoveCurrent();
+
+            bChanged |= ReportsByPackage.Remove(PackageName) > 0;
+            TArray<FAssetData> PackageAssets;
+            IAssetRegistry::GetChecked().GetAssetsByPackageName(PackageName,
+                                                                PackageAssets,
+                                                                /*bIncludeOnlyOnDiskAssets*/ false);
+            Slice.Append(MoveTemp(PackageAssets));
+        }
+        while (SweepCursor < SweepQueue.Num() && Slice.Num() < SliceSize)
+        {
+            const auto& AssetData = SweepQueue[SweepCursor++];
+            SweepQueued.Remove(AssetData.GetSoftObjectPath());
+            Slice.Add(AssetData);
+        }
+
+        if (0 == Slice.Num())
+        {
+            break;
+        }
+        bChanged |= ValidateSlice(Slice);
+    }
+    while (FPlatformTime::Seconds() < EndTime);
+
+    if (SweepQueue.Num() > 0 && SweepCursor == SweepQueue.Num())
+    {
+        UE_LOG(LogMetaWeaver,
+               Log,
+               TEXT("Issue index sweep of %d assets complete; %d packages have issues"),
+               SweepQueue.Num(),
+               ReportsByPackage.Num());
+        SweepQueue.Empty();
+        SweepQueued.Empty();
+        SweepCursor = 0;
+        bSweepComplete = true;
+    }
+    SET_DWORD_STAT(STAT_MetaWeaver_IssueIndexPendingAssets, GetNumPending());
+
+    if (bChanged)
+    {
+        IssueIndexChangedEvent.Broadcast();
+    }
+    return true;
+}
+
+void UMetaWeaverIssueIndexSubsystem::QueueSweep(const FMetaWeaverDefinitionSetsChange* Change)
+{
+    FARFilter Filter;
+    Filter.PackagePaths.Add(GameContentPath);
+    Filter.bRecursivePaths = true;
+
+    TArray<FAssetData> Assets;
+    IAssetRegistry::GetChecked().GetAssets(Filter, Assets);
+    if (Change && !Change->bAffectsAll)
+    {
+        // Assets whose class is not loaded can not be matched, so they are revisited to be safe
+        Assets.RemoveAllSwap([Change](const FAssetData& AssetData) {
+            const auto Class = AssetData.GetClass();
+            return Class && !Change->AffectsClass(Class);
+        });
+    }
+    Assets.RemoveAllSwap([](const FAssetData& AssetData) { return AssetData.IsRedirector(); });
+
+    // Drop the visited part of a sweep in progress and continue with the new assets after the remaining ones. Every
+    // edit of a definition set queues a sweep, so assets still waiting are not queued again.
+    SweepQueue.RemoveAt(0, SweepCursor);
+    SweepCursor = 0;
+    SweepQueue.Reserve(SweepQueue.Num() + Assets.Num());
+    for (auto& AssetData : Assets)
+    {
+        bool bAlreadyQueued{ false };
+        SweepQueued.Add(AssetData.GetSoftObjectPath(), &bAlreadyQueued);
+        if (!bAlreadyQueued)
+        {
+            SweepQueue.Add(MoveTemp(AssetData));
+        }
+    }
+    bSweepComplete = 0 == SweepQueue.Num();
+}
+
+bool UMetaWeaverIssueIndexSubsystem::ValidateSlice(const TArray<FAssetData>& Slice)
+{
+    // Only validate what can be validated without loading; the rest is indexed when it is loaded or saved
+    TArray<FAssetData> Validatable;
+    Validatable.Reserve(Slice.Num());
+    for (const auto& AssetData : Slice)
+    {
+        if (AssetData.IsAssetLoaded() || FMetaWeaverMetadataStore::CanReadUnloadedMetadataTags(AssetData))
+        {
+            Validatable.Add(AssetData);
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_MetaWeaver_IssueIndexAssetsValidated, Validatable.Num());
+
+    auto Batch = ValidationSubsystem->ValidateAssetData(Validatable);
+    auto bChanged{ false };
+    for (int32 Index = 0; Index < Validatable.Num(); ++Index)
+    {
+        bChanged |= SetReport(Validatable[Index].PackageName, MoveTemp(Batch.Reports[Index]));
+    }
+    return bChanged;
+}
+
+bool UMetaWeaverIssueIndexSubsystem::SetReport(const FName PackageName, FMetaWeaverValidationReport&& Report)
+{
+    auto bChanged = RemoveReport(PackageName, Report.Asset);
+    if (Report.Issues.Num() > 0)
+    {
+        ReportsByPackage.FindOrAdd(PackageName).Add(MoveTemp(Report));
+        bChanged = true;
+    }
+    return bChanged;
+}
+
+bool UMetaWeaverIssueIndexSubsystem::RemoveReport(const FName PackageName, const FSoftObjectPath& Asset)
+{
+    auto bRemoved{ false };
+    if (const auto Reports = ReportsByPackage.Find(PackageName))
+    {
+        bRemoved = Reports->RemoveAllSwap([&Asset](const FMetaWeaverValidationReport& Report) {
+            return Asset == Report.Asset;
+        }) > 0;
+        if (0 == Reports->Num())
+        {
+            ReportsByPackage.Remove(PackageName);
+        }
+    }
+    return bRemoved;
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnObjectModified(UObject* Object)
+{
+    // Called for every transacted edit, so only record the package and validate it on the next tick
+    if (const auto Package = Object ? Object->GetPackage() : nullptr;
+        Package && Package != GetTransientPackage() && !Package->HasAnyPackageFlags(PKG_CompiledIn))
+    {
+        DirtyPackages.Add(Package->GetFName());
+    }
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnPackageSaved(const FString&, UPackage* Package, FObjectPostSaveContext)
+{
+    if (Package)
+    {
+        DirtyPackages.Add(Package->GetFName());
+    }
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnMetadataChanged(const UPackage* Package)
+{
+    if (Package)
+    {
+        DirtyPackages.Add(Package->GetFName());
+    }
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnAssetRemoved(const FAssetData& AssetData)
+{
+    if (RemoveReport(AssetData.PackageName, AssetData.GetSoftObjectPath()))
+    {
+        IssueIndexChangedEvent.Broadcast();
+    }
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+    const FSoftObjectPath OldPath(OldObjectPath);
+    if (RemoveReport(OldPath.GetLongPackageFName(), OldPath))
+    {
+        IssueIndexChangedEvent.Broadcast();
+    }
+    DirtyPackages.Add(AssetData.PackageName);
+}
+
+void UMetaWeaverIssueIndexSubsystem::OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change)
+{
+    // Before the first sweep there is nothing to refresh; the full sweep will see the new definitions
+    if (!bFullSweepRequested)
+    {
+        QueueSweep(&Change);
+    }
+}
@@ -0,0 +1,423 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverReportWriter.h"
+#include "AssetRegistry/AssetData.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Class.h"
+
+namespace
+{
+    FString GetSeverityName(const EMetaWeaverIssueSeverity Severity)
+    {
+        return StaticEnum<EMetaWeaverIssueSeverity>()->GetNameStringByValue(static_cast<int64>(Severity));
+    }
+
+    // The message as shown in the editor, prefixed with the key it applies to
+    FString GetQualifiedMessage(const FMetaWeaverIssue& Issue)
+    {
+        return Issue.Key.IsNone()
+            ? Issue.GetMessage().ToString()
+            : FString::Printf(TEXT("Metadata '%s': %s"), *Issue.Key.ToString(), *Issue.GetMessage().ToString());
+    }
+
+    // The package file of the asset relative to the project directory, with forward slashes
+    FString GetRelativePackageFilename(const FAssetData& AssetData)
+    {
+        const auto& Extension = AssetData.HasAnyPackageFlags(PKG_ContainsMap)
+            ? FPackageName::GetMapPackageExtension()
+            : FPackageName::GetAssetPackageExtension();
+        FString Filename;
+        if (FPackageName::TryConvertLongPackageNameToFilename(AssetData.PackageName.ToString(), Filename, Extension))
+        {
+            Filename = FPaths::ConvertRelativePathToFull(Filename);
+            FPaths::MakePathRelativeTo(Filename, *FPaths::ConvertRelativePathToFull(FPaths::ProjectDir()));
+        }
+        return Filename;
+    }
+
+    void AppendJsonString(FStringBuilderBase& Out, const FStringView Value)
+    {
+        Out.AppendChar(TEXT('"'));
+        for (const auto Char : Value)
+        {
+            switch (Char)
+            {
+                case TEXT('"'):
+                    Out.Append(TEXT("\\\""));
+                    break;
+                case TEXT('\\'):
+                    Out.Append(TEXT("\\\\"));
+                    break;
+                case TEXT('\n'):
+                    Out.Append(TEXT("\\n"));
+                    break;
+                case TEXT('\r'):
+                    Out.Append(TEXT("\\r"));
+                    break;
+                case TEXT('\t'):
+                    Out.Append(TEXT("\\t"));
+                    break;
+                default:
+                    if (Char < 0x20)
+                    {
+                        Out.Appendf(TEXT("\\u%04x"), static_cast<uint32>(Char));
+                    }
+                    else
+                    {
+                        Out.AppendChar(Char);
+                    }
+                    break;
+            }
+        }
+        Out.AppendChar(TEXT('"'));
+    }
+
+    void AppendXmlEscaped(FStringBuilderBase& Out, const FStringView Value)
+    {
+        for (const auto Char : Value)
+        {
+            switch (Char)
+            {
+                case TEXT('&'):
+                    Out.Append(TEXT("&amp;"));
+                    break;
+                case TEXT('<'):
+                    Out.Append(TEXT("&lt;"));
+                    break;
+                case TEXT('>'):
+                    Out.Append(TEXT("&gt;"));
+                    break;
+                case TEXT('"'):
+                    Out.Append(TEXT("&quot;"));
+                    break;
+                case TEXT('\''):
+                    Out.Append(TEXT("&apos;"));
+                    break;
+                default:
+                    // Control characters other than whitespace are not allowed in XML 1.0
+                    if (Char >= 0x20 || TEXT('\t') == Char || TEXT('\n') == Char || TEXT('\r') == Char)
+                    {
+                        Out.AppendChar(Char);
+                    }
+                    break;
+            }
+        }
+    }
+
+    // How an issue relates to the baseline the report is compared against, if any
+    enum class EBaselineState : uint8
+    {
+        None,
+        New,
+        Resolved
+    };
+
+    /**
+     * One JSON object per issue and line. Assets without issues produce no output. Relative to a baseline, every
+     * issue carries a status of "new" or "resolved".
+     */
+    class FJsonLinesWriter final : public FMetaWeaverReportWriter
+    {
+    public:
+        explicit FJsonLinesWriter(FArchive& InAr) : FMetaWeaverReportWriter(InAr) {}
+
+        virtual void Write(const FAssetData& AssetData,
+                           const FMetaWeaverValidationReport& Report,
+                           const FMetaWeaverValidationReport* Resolved) override
+        {
+            WriteIssues(AssetData, Report, Resolved ? EBaselineState::New : EBaselineState::None);
+            if (Resolved)
+            {
+                WriteIssues(AssetData, *Resolved, EBaselineState::Resolved);
+            }
+        }
+
+    private:
+        void WriteIssues(const FAssetData& AssetData,
+                         const FMetaWeaverValidationReport& Report,
+                         const EBaselineState State) const
+        {
+            TStringBuilder<512> Line;
+            for (const auto& Issue : Report.Issues)
+            {
+                Line.Reset();
+                Line << TEXT("{\"asset\":");
+                AppendJsonString(Line, Report.Asset.ToString());
+                Line << TEXT(",\"class\":");
+                AppendJsonString(Line, AssetData.AssetClassPath.ToString());
+                Line << TEXT(",\"key\":");
+                AppendJsonString(Line, Issue.Key.IsNone() ? FString() : Issue.Key.ToString());
+                Line << TEXT(",\"severity\":");
+                AppendJsonString(Line, GetSeverityName(Issue.Severity));
+                Line << TEXT(",\"code\":");
+                AppendJsonString(Line, Issue.GetCodeName());
+                // Both are written as the argument, which the code gives meaning to
+                if (!Issue.Argument.IsNone())
+                {
+                    Line << TEXT(",\"argument\":");
+                    AppendJsonString(Line, Issue.Argument.ToString());
+                }
+                else if (Issue.RelatedAsset.IsValid())
+                {
+                    Line << TEXT(",\"argument\":");
+                    AppendJsonString(Line, Issue.RelatedAsset.ToString());
+                }
+                if (EBaselineState::None != State)
+                {
+                    Line << TEXT(",\"status\":");
+                    Line << (EBaselineState::New == State ? TEXT("\"new\"") : TEXT("\"resolved\""));
+                }
+                Line << TEXT(",\"message\":");
+                AppendJsonString(Line, Issue.GetMessage().ToString());
+                Line << TEXT("}\n");
+                WriteUtf8(Line);
+            }
+        }
+    };
+
+    /**
+     * A SARIF 2.1.0 log with one rule per issue code and one result per issue. Relative to a baseline, results carry
+     * a baselineState of "new", and resolved issues are written as passing results with a baselineState of "absent".
+     */
+    class FSarifWriter final : public FMetaWeaverReportWriter
+    {
+    public:
+        explicit FSarifWriter(FArchive& InAr) : FMetaWeaverReportWriter(InAr) {}
+
+        virtual void Begin() override
+        {
+            TStringBuilder<2048> Header;
+            Header << TEXT("{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",");
+            Header << TEXT("\"runs\":[{\"tool\":{\"driver\":{\"name\":\"MetaWeaver\",\"rules\":[");
+
+            // The last entry of a UENUM is the generated _MAX
+            const auto Enum = StaticEnum<EMetaWeaverIssueCode>();
+            for (int32 Index = 0; Index < Enum->NumEnums() - 1; ++Index)
+            {
+                FMetaWeaverIssue Issue;
+                Issue.Code = static_cast<EMetaWeaverIssueCode>(Enum->GetValueByIndex(Index));
+                Header << (0 == Index ? TEXT("\n") : TEXT(",\n")) << TEXT("{\"id\":");
+                AppendJsonString(Header, Issue.GetCodeName());
+                Header << TEXT(",\"shortDescription\":{\"text\":");
+                AppendJsonString(Header, Issue.GetMessage().ToString());
+                Header << TEXT("}}");
+            }
+            Header << TEXT("]}},\"results\":[");
+            WriteUtf8(Header);
+        }
+
+        virtual void Write(const FAssetData& AssetData,
+                           const FMetaWeaverValidationReport& Report,
+                           const FMetaWeaverValidationReport* Resolved) override
+        {
+            // The package filename is only resolved for assets that have issues
+            if (Report.Issues.Num() > 0 || (Resolved && Resolved->Issues.Num() > 0))
+            {
+                const auto Filename = GetRelativePackageFilename(AssetData);
+                WriteResults(Filename, Report, Resolved ? EBaselineState::New : EBaselineState::None);
+                if (Resolved)
+                {
+                    WriteResults(Filename, *Resolved, EBaselineState::Resolved);
+                }
+            }
+        }
+
+        virtual void End() override { WriteUtf8(TEXT("\n]}]}\n")); }
+
+    private:
+        static const TCHAR* GetLevel(const EMetaWeaverIssueSeverity Severity)
+        {
+            switch (Severity)
+            {
+                case EMetaWeaverIssueSeverity::Error:
+                    return TEXT("error");
+                case EMetaWeaverIssueSeverity::Warning:
+                    return TEXT("warning");
+                default:
+                    return TEXT("note");
+            }
+        }
+
+        void WriteResults(const FString& Filename,
+                          const FMetaWeaverValidationReport& Report,
+                          const EBaselineState State)
+        {
+            const auto Asset = Report.Asset.ToString();
+            TStringBuilder<1024> Result;
+            for (const auto& Issue : Report.Issues)
+            {
+                Result.Reset();
+                Result << (bFirstResult ? TEXT("\n") : TEXT(",\n")) << TEXT("{\"ruleId\":");
+                AppendJsonString(Result, Issue.GetCodeName());
+                if (EBaselineState::Resolved == State)
+                {
+                    // A resolved issue no longer fails, which SARIF expresses as an absent pass without a level
+                    Result << TEXT(",\"kind\":\"pass\",\"level\":\"none\",\"baselineState\":\"absent\"");
+                }
+                else
+                {
+                    Result << TEXT(",\"level\":\"") << GetLevel(Issue.Severity) << TEXT("\"");
+                    if (EBaselineState::New == State)
+                    {
+                        Result << TEXT(",\"baselineState\":\"new\"");
+                    }
+                }
+                Result << TEXT(",\"message\":{\"text\":");
+                AppendJsonString(Result, GetQualifiedMessage(Issue));
+                Result << TEXT("},\"locations\":[{");
+                if (!Filename.IsEmpty())
+                {
+                    Result << TEXT("\"physicalLocation\":{\"artifactLocation\":{\"uri\":");
+                    AppendJsonString(Result, Filename);
+                    Result << TEXT("}},");
+                }
+                Result << TEXT("\"logicalLocations\":[{\"kind\":\"object\",\"fullyQualifiedName\":");
+                AppendJsonString(Result, Asset);
+                Result << TEXT("}]}]");
+                if (!Issue.Key.IsNone())
+                {
+                    Result << TEXT(",\"properties\":{\"metadataKey\":");
+                    AppendJsonString(Result, Issue.Key.ToString());
+                    Result << TEXT("}");
+                }
+                Result << TEXT("}");
+                WriteUtf8(Result);
+                bFirstResult = false;
+            }
+        }
+
+        bool bFirstResult{ true };
+    };
+
+    /**
+     * A JUnit XML report with one test case per validated asset, grouped by package path.
+     * Errors fail the test case; warnings and notes are attached as output of a passing test case. Relative to a
+     * baseline, only new errors fail and resolved issues are listed in the output.
+     */
+    class FJUnitWriter final : public FMetaWeaverReportWriter
+    {
+    public:
+        explicit FJUnitWriter(FArchive& InAr) : FMetaWeaverReportWriter(InAr) {}
+
+        virtual void Begin() override
+        {
+            WriteUtf8(TEXT("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                           "<testsuites name=\"MetaWeaver\">\n<testsuite name=\"MetaWeaver\">\n"));
+        }
+
+        virtual void Write(const FAssetData& AssetData,
+                           const FMetaWeaverValidationReport& Report,
+                           const FMetaWeaverValidationReport* Resolved) override
+        {
+            TStringBuilder<1024> TestCase;
+            TestCase << TEXT("<testcase classname=\"");
+            AppendXmlEscaped(TestCase, AssetData.PackagePath.ToString());
+            TestCase << TEXT("\" name=\"");
+            AppendXmlEscaped(TestCase, AssetData.AssetName.ToString());
+            TestCase << TEXT("\"");
+            if (0 == Report.Issues.Num() && (!Resolved || 0 == Resolved->Issues.Num()))
+            {
+                TestCase << TEXT("/>\n");
+            }
+            else
+            {
+                // JUnit allows a single failure per test case, so it names the first error and lists every issue
+                const auto FirstError = Report.Issues.FindByPredicate(
+                    [](const FMetaWeaverIssue& Issue) { return EMetaWeaverIssueSeverity::Error == Issue.Severity; });
+                if (FirstError)
+                {
+                    TestCase << TEXT("><failure type=\"") << FirstError->GetCodeName() << TEXT("\" message=\"");
+                    AppendXmlEscaped(TestCase, GetQualifiedMessage(*FirstError));
+                    TestCase << TEXT("\">");
+                }
+                else
+                {
+                    TestCase << TEXT("><system-out>");
+                }
+                AppendIssueLines(TestCase, Report, Resolved ? EBaselineState::New : EBaselineState::None);
+                if (Resolved)
+                {
+                    AppendIssueLines(TestCase, *Resolved, EBaselineState::Resolved);
+                }
+                TestCase << (FirstError ? TEXT("</failure>") : TEXT("</system-out>")) << TEXT("</testcase>\n");
+            }
+            WriteUtf8(TestCase);
+        }
+
+        virtual void End() override { WriteUtf8(TEXT("</testsuite>\n</testsuites>\n")); }
+
+    private:
+        static void AppendIssueLines(FStringBuilderBase& Out,
+                                     const FMetaWeaverValidationReport& Report,
+                                     const EBaselineState State)
+        {
+            const auto Prefix = EBaselineState::New == State ? TEXT("New ")
+                : EBaselineState::Resolved == State          ? TEXT("Resolved ")
+                                                             : TEXT("");
+            for (const auto& Issue : Report.Issues)
+            {
+                Out << Prefix << GetSeverityName(Issue.Severity) << TEXT(" [") << Issue.GetCodeName() << TEXT("] ");
+                AppendXmlEscaped(Out, GetQualifiedMessage(Issue));
+                Out << TEXT("\n");
+            }
+        }
+    };
+} // namespace
+
+TUniquePtr<FMetaWeaverReportWriter> FMetaWeaverReportWriter::Create(const FString& Format, FArchive& Ar)
+{
+    if (Format.Equals(TEXT("junit"), ESearchCase::IgnoreCase))
+    {
+        return MakeUnique<FJUnitWriter>(Ar);
+    }
+    else if (Format.Equals(TEXT("sarif"), ESearchCase::IgnoreCase))
+    {
+        return MakeUnique<FSarifWriter>(Ar);
+    }
+    else if (Format.Equals(TEXT("jsonl"), ESearchCase::IgnoreCase))
+    {
+        return MakeUnique<FJsonLinesWriter>(Ar);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+FString FMetaWeaverReportWriter::GetExtension(const FString& Format)
+{
+    if (Format.Equals(TEXT("junit"), ESearchCase::IgnoreCase))
+    {
+        return TEXT(".xml");
+    }
+    else if (Format.Equals(TEXT("sarif"), ESearchCase::IgnoreCase))
+    {
+        return TEXT(".sarif");
+    }
+    else if (Format.Equals(TEXT("jsonl"), ESearchCase::IgnoreCase))
+    {
+        return TEXT(".jsonl");
+    }
+    else
+    {
+        return FString();
+    }
+}
+
+void FMetaWeaverReportWriter::WriteUtf8(const FStringView Text) const
+{
+    const auto Utf8 = StringCast<UTF8CHAR>(Text.GetData(), Text.Len());
+    Ar.Serialize(const_cast<UTF8CHAR*>(Utf8.Get()), Utf8.Length() * sizeof(UTF8CHAR));
+}
@@ -0,0 +1,58 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+
+struct FAssetData;
+
+/**
+ * Streams validation reports to an archive in a format understood by build systems.
+ * Reports are written as they are produced so memory use does not grow with the number of assets validated.
+ */
+class FMetaWeaverReportWriter
+{
+public:
+    /** Return a writer for the format (junit, sarif or jsonl), or null if the format is unknown. */
+    static TUniquePtr<FMetaWeaverReportWriter> Create(const FString& Format, FArchive& Ar);
+
+    /** Return the file extension used for the format, including the leading dot, or empty if the format is unknown. */
+    static FString GetExtension(const FString& Format);
+
+    virtual ~FMetaWeaverReportWriter() = default;
+
+    /** Write anything that precedes the first report. */
+    virtual void Begin() {}
+
+    /**
+     * Write the report of a single validated asset.
+     * When comparing against a baseline, Report holds only the issues that are new and Resolved holds the baseline
+     * issues that are no longer reported.
+     */
+    virtual void Write(const FAssetData& AssetData,
+                       const FMetaWeaverValidationReport& Report,
+                       const FMetaWeaverValidationReport* Resolved = nullptr) = 0;
+
+    /** Write anything that follows the last report. */
+    virtual void End() {}
+
+protected:
+    explicit FMetaWeaverReportWriter(FArchive& InAr) : Ar(InAr) {}
+
+    /** Encode the text as UTF-8 and append it to the archive. */
+    void WriteUtf8(FStringView Text) const;
+
+    FArchive& Ar;
+};
@@ -0,0 +1,237 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverUniquenessIndex.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverMetadataStore.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "MetaWeaver/MetaWeaverTypes.h"
+
+void FMetaWeaverUniquenessIndex::Invalidate()
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+    AssetsByValue.Empty();
+    ValuesByAsset.Empty();
+    bBuilt = false;
+
+    bBuilding = false;
+    BuildQueue.Empty();
+    BuildCursor = 0;
+    BuildSpecTables.Empty();
+    RemovedWhileBuilding.Empty();
+    NumUnprojected = 0;
+    BuildSeconds = 0.0;
+}
+
+void FMetaWeaverUniquenessIndex::Build(const FGetSpecTable GetSpecTable)
+{
+    BuildUntil(GetSpecTable, TNumericLimits<double>::Max());
+}
+
+bool FMetaWeaverUniquenessIndex::BuildUntil(const FGetSpecTable GetSpecTable, const double EndTime)
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_BuildUniquenessIndex);
+    check(IsInGameThread());
+
+    if (bBuilt)
+    {
+        return true;
+    }
+
+    const auto StartTime = FPlatformTime::Seconds();
+    if (!bBuilding)
+    {
+        Invalidate();
+        bBuilding = true;
+
+        auto& AssetRegistry = IAssetRegistry::GetChecked();
+        if (IsRunningCommandlet())
+        {
+            // A commandlet only scans the paths it validates, and every asset under /Game can collide
+            AssetRegistry.ScanPathsSynchronous({ TEXT("/Game") });
+        }
+
+        FARFilter Filter;
+        Filter.PackagePaths.Add(TEXT("/Game"));
+        Filter.bRecursivePaths = true;
+        AssetRegistry.GetAssets(Filter, BuildQueue);
+    }
+
+    const TMap<FName, FString> NoTags;
+    TMap<FName, FString> UnloadedTags;
+    while (BuildCursor < BuildQueue.Num() && FPlatformTime::Seconds() < EndTime)
+    {
+        const auto& AssetData = BuildQueue[BuildCursor++];
+        const auto Class = AssetData.GetClass();
+        if (!Class || RemovedWhileBuilding.Contains(AssetData.GetSoftObjectPath()))
+        {
+            continue;
+        }
+
+        auto SpecTable = BuildSpecTables.Find(Class);
+        if (!SpecTable)
+        {
+            SpecTable = &BuildSpecTables.Add(Class, GetSpecTable(Class));
+        }
+        if (!(*SpecTable)->HasUniqueSpecs())
+        {
+            continue;
+        }
+
+        const TMap<FName, FString>* Tags{ nullptr };
+        if (const auto Loaded = AssetData.FastGetAsset(false))
+        {
+            Tags = FMetaWeaverMetadataStore::FindMetadataTags(Loaded);
+        }
+        else if (FMetaWeaverMetadataStore::TryReadUnloadedMetadataTags(AssetData, UnloadedTags))
+        {
+            Tags = &UnloadedTags;
+        }
+        else
+        {
+            ++NumUnprojected;
+            continue;
+        }
+        Update(AssetData.GetSoftObjectPath(), **SpecTable, Tags ? *Tags : NoTags);
+    }
+    BuildSeconds += FPlatformTime::Seconds() - StartTime;
+
+    if (BuildCursor == BuildQueue.Num())
+    {
+        UE_LOG(LogMetaWeaver,
+               Log,
+               TEXT("Built the uniqueness index of %d assets in %.2fs"),
+               ValuesByAsset.Num(),
+               BuildSeconds);
+        if (NumUnprojected > 0)
+        {
+            UE_LOG(LogMetaWeaver,
+                   Warning,
+                   TEXT("%d assets with unique keys were saved without a metadata projection and are not checked for "
+                        "collisions until they are saved again"),
+                   NumUnprojected);
+        }
+
+        bBuilt = true;
+        bBuilding = false;
+        BuildQueue.Empty();
+        BuildCursor = 0;
+        BuildSpecTables.Empty();
+        RemovedWhileBuilding.Empty();
+    }
+    return bBuilt;
+}
+
+void FMetaWeaverUniquenessIndex::Update(const FSoftObjectPath& Asset,
+                                        const FMetaWeaverSpecTable& SpecTable,
+                                        const TMap<FName, FString>& Tags)
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+    RemoveLocked(Asset);
+
+    TArray<TPair<FScopedKey, FString>> Values;
+    for (const auto& Spec : SpecTable.GetSpecs())
+    {
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Value = Spec.bUnique ? Tags.Find(Spec.Key) : nullptr;
+        if (Value && !Value->IsEmpty())
+        {
+            FScopedKey ScopedKey{ SpecTable.GetDeclaringType(Spec), Spec.Key };
+            auto IndexedValue = GetIndexedValue(Spec, *Value);
+            AssetsByValue.FindOrAdd(ScopedKey).FindOrAdd(IndexedValue).Add(Asset);
+            Values.Emplace(MoveTemp(ScopedKey), MoveTemp(IndexedValue));
+        }
+    }
+    if (Values.Num() > 0)
+    {
+        ValuesByAsset.Add(Asset, MoveTemp(Values));
+    }
+}
+
+void FMetaWeaverUniquenessIndex::Remove(const FSoftObjectPath& Asset)
+{
+    FRWScopeLock ScopeLock(Lock, SLT_Write);
+    RemoveLocked(Asset);
+    if (bBuilding)
+    {
+        // The build read the asset registry before the asset was removed
+        RemovedWhileBuilding.Add(Asset);
+    }
+}
+
+FSoftObjectPath FMetaWeaverUniquenessIndex::FindOtherAsset(const FMetaWeaverSpecTable& SpecTable,
+                                                           const FMetadataParameterSpec& Spec,
+                                                           const FString& Value,
+                                                           const FSoftObjectPath& Asset) const
+{
+    if (Spec.bUnique && !Value.IsEmpty())
+    {
+        const FScopedKey ScopedKey{ SpecTable.GetDeclaringType(Spec), Spec.Key };
+        const auto IndexedValue = GetIndexedValue(Spec, Value);
+
+        FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+        if (const auto AssetsByKeyValue = AssetsByValue.Find(ScopedKey))
+        {
+            if (const auto Assets = AssetsByKeyValue->Find(IndexedValue))
+            {
+                // The order of the assets depends on the order of updates, so report the lowest path to report the
+                // same asset on every run
+                const FSoftObjectPath* Lowest{ nullptr };
+                for (const auto& Other : *Assets)
+                {
+                    if (Other != Asset && (!Lowest || Other.LexicalLess(*Lowest)))
+                    {
+                        Lowest = &Other;
+                    }
+                }
+                if (Lowest)
+                {
+                    return *Lowest;
+                }
+            }
+        }
+    }
+    return FSoftObjectPath();
+}
+
+FString FMetaWeaverUniquenessIndex::GetIndexedValue(const FMetadataParameterSpec& Spec, const FString& Value)
+{
+    // Equal numbers may be written differently ("01" and "1"), so compare canonical forms where the value parses
+    FString Canonical;
+    return FMetaWeaverValue::Canonicalize(Spec.Type, Value, Canonical) ? Canonical : Value;
+}
+
+void FMetaWeaverUniquenessIndex::RemoveLocked(const FSoftObjectPath& Asset)
+{
+    TArray<TPair<FScopedKey, FString>> Values;
+    if (ValuesByAsset.RemoveAndCopyValue(Asset, Values))
+    {
+        for (const auto& [ScopedKey, IndexedValue] : Values)
+        {
+            auto& AssetsByKeyValue = AssetsByValue.FindChecked(ScopedKey);
+            auto& Assets = AssetsByKeyValue.FindChecked(IndexedValue);
+            Assets.RemoveSingleSwap(Asset);
+            if (0 == Assets.Num())
+            {
+                AssetsByKeyValue.Remove(IndexedValue);
+                if (0 == AssetsByKeyValue.Num())
+                {
+                    AssetsByValue.Remove(ScopedKey);
+                }
+            }
+        }
+    }
+}
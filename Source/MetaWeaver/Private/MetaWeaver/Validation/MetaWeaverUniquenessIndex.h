@@ -0,0 +1,96 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+
+struct FMetadataParameterSpec;
+
+/**
+ * Maps the value of every unique key to the assets that use it, so that a collision is a hash lookup rather than a
+ * scan of every asset. Only assets whose effective spec for a key is unique are recorded under that key, and keys are
+ * scoped by the ObjectType that declared the spec, so only assets of that type are compared with each other.
+ *
+ * The index is built once from the metadata projected into the asset registry (or the metadata of loaded assets) and
+ * is then kept current from package saves. Assets saved without a projection are recorded once they are saved again.
+ * Values are compared in canonical form, and strings are compared case-insensitively.
+ */
+class FMetaWeaverUniquenessIndex final
+{
+public:
+    using FGetSpecTable = TFunctionRef<FMetaWeaverSpecTableRef(const UClass*)>;
+
+    /** Return true if the index has been built since it was created or last invalidated. */
+    bool IsBuilt() const { return bBuilt; }
+
+    /** Return true while a time-sliced build is in progress. The index is incomplete until it is built. */
+    bool IsBuilding() const { return bBuilding; }
+
+    /** Discard every entry, because which keys are unique may have changed. Cancels a build in progress. */
+    void Invalidate();
+
+    /** Record the unique values of every asset under /Game, completing a build in progress. Game thread only. */
+    void Build(FGetSpecTable GetSpecTable);
+
+    /**
+     * Record the unique values of assets under /Game until EndTime (in FPlatformTime::Seconds()), starting a build if
+     * none is in progress, so the index can be built over several frames. Returns true once it is built. A commandlet
+     * scans /Game synchronously when the build starts. Game thread only.
+     */
+    bool BuildUntil(FGetSpecTable GetSpecTable, double EndTime);
+
+    /** Replace the recorded values of the asset with the unique values among the tags. Game thread only. */
+    void Update(const FSoftObjectPath& Asset, const FMetaWeaverSpecTable& SpecTable, const TMap<FName, FString>& Tags);
+
+    /** Forget the recorded values of the asset. Game thread only. */
+    void Remove(const FSoftObjectPath& Asset);
+
+    /**
+     * Return the lexically lowest path of the assets other than Asset that use the value for the unique spec, or an
+     * empty path if there is none. Spec must be an element of SpecTable. Safe from any thread.
+     */
+    FSoftObjectPath FindOtherAsset(const FMetaWeaverSpecTable& SpecTable,
+                                   const FMetadataParameterSpec& Spec,
+                                   const FString& Value,
+                                   const FSoftObjectPath& Asset) const;
+
+private:
+    // The ObjectType that declared a unique spec and its key
+    using FScopedKey = TPair<FTopLevelAssetPath, FName>;
+
+    static FString GetIndexedValue(const FMetadataParameterSpec& Spec, const FString& Value);
+
+    void RemoveLocked(const FSoftObjectPath& Asset);
+
+    mutable FRWLock Lock;
+
+    // Scoped key -> indexed value -> assets using it. More than one asset under a value is a collision.
+    TMap<FScopedKey, TMap<FString, TArray<FSoftObjectPath, TInlineAllocator<1>>>> AssetsByValue;
+
+    // Asset -> the scoped keys and indexed values recorded for it, so an update can remove the previous values
+    TMap<FSoftObjectPath, TArray<TPair<FScopedKey, FString>>> ValuesByAsset;
+
+    bool bBuilt{ false };
+
+    // State of the build in progress. Assets are read from BuildCursor on.
+    bool bBuilding{ false };
+    TArray<FAssetData> BuildQueue;
+    int32 BuildCursor{ 0 };
+    TMap<const UClass*, FMetaWeaverSpecTableRef> BuildSpecTables;
+    TSet<FSoftObjectPath> RemovedWhileBuilding;
+    int32 NumUnprojected{ 0 };
+    double BuildSeconds{ 0.0 };
+};
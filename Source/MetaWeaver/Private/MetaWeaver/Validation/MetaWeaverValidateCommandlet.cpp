@@ -0,0 +1,455 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverValidateCommandlet.h"
+#include "Algo/Unique.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Editor.h"
+#include "HAL/FileManager.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
+#include "MetaWeaver/MetaWeaverProjectSettings.h"
+#include "MetaWeaver/Validation/MetaWeaverReportWriter.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationBaseline.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverValidateCommandlet)
+
+namespace
+{
+    constexpr int32 DefaultBatchSize = 2048;
+
+    // Assets loaded because they were saved before the tag projection existed are released once they have added this
+    // many objects, so a project-wide run does not keep every such asset resident
+    constexpr int32 GarbageCollectionObjectThreshold = 100000;
+
+    /** The packages named by a changed file list. */
+    struct FChangedFiles
+    {
+        TArray<FString> PackageFilenames;
+        TArray<FName> PackageNames;
+
+        // The config file holding the active definition sets changed, so any spec may have changed
+        bool bProjectSettingsChanged{ false };
+    };
+
+    TArray<FString> ParseList(const TMap<FString, FString>& Params, const TCHAR* Name)
+    {
+        TArray<FString> Values;
+        if (const auto Found = Params.Find(Name))
+        {
+            static const TCHAR* Delimiters[] = { TEXT("+"), TEXT(",") };
+            Found->ParseIntoArray(Values, Delimiters, UE_ARRAY_COUNT(Delimiters));
+            for (auto& Value : Values)
+            {
+                Value.TrimStartAndEndInline();
+            }
+        }
+        return Values;
+    }
+
+    // Accept class path names (/Script/Engine.StaticMesh) as well as short names (StaticMesh)
+    bool ResolveClassPaths(const TArray<FString>& Names, TArray<FTopLevelAssetPath>& OutClassPaths)
+    {
+        for (const auto& Name : Names)
+        {
+            if (Name.StartsWith(TEXT("/")))
+            {
+                OutClassPaths.Emplace(Name);
+            }
+            else if (const auto Class = UClass::TryFindTypeSlow<UClass>(Name))
+            {
+                OutClassPaths.Add(Class->GetClassPathName());
+            }
+            else
+            {
+                UE_LOG(LogMetaWeaver, Error, TEXT("Unknown class '%s'"), *Name);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Read a list of changed files, one per line and relative to the project directory unless absolute, such as the
+    // output of "git diff --name-only". Packages are kept; other files are ignored except for the project settings.
+    bool ReadChangedFiles(const FString& ListFilename, FChangedFiles& OutChanged)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *ListFilename))
+        {
+            UE_LOG(LogMetaWeaver, Error, TEXT("Failed to read the changed file list %s"), *ListFilename);
+            return false;
+        }
+
+        const auto SettingsFilename = GetDefault<UMetaWeaverProjectSettings>()->GetDefaultConfigFilename();
+        for (auto& Line : Lines)
+        {
+            Line.TrimStartAndEndInline();
+            if (Line.IsEmpty())
+            {
+                continue;
+            }
+            auto Filename = FPaths::IsRelative(Line) ? FPaths::Combine(FPaths::ProjectDir(), Line) : Line;
+            Filename = FPaths::ConvertRelativePathToFull(Filename);
+
+            const auto Extension = FPaths::GetExtension(Filename, /*bIncludeDot*/ true);
+            FString PackageName;
+            if ((Extension == FPackageName::GetAssetPackageExtension()
+                 || Extension == FPackageName::GetMapPackageExtension())
+                && FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName))
+            {
+                OutChanged.PackageFilenames.Add(MoveTemp(Filename));
+                OutChanged.PackageNames.Add(FName(PackageName));
+            }
+            else if (FPaths::IsSamePath(Filename, SettingsFilename))
+            {
+                OutChanged.bProjectSettingsChanged = true;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Collect the classes that the changed definition sets define specs for, as assets of those classes (and their
+     * subclasses) may now validate differently. Return true if every asset may be affected, because a set defines
+     * specs for every class or could not be loaded.
+     * Classes that a set stopped defining specs for can not be told from the current set, so their assets are only
+     * revalidated once they change themselves or by a full run.
+     */
+    bool GatherClassesAffectedByDefinitionSets(const TArray<FName>& ChangedPackages,
+                                               TArray<FTopLevelAssetPath>& OutAffectedClasses)
+    {
+        FARFilter Filter;
+        Filter.PackageNames = ChangedPackages;
+        Filter.ClassPaths.Add(UMetaWeaverMetadataDefinitionSet::StaticClass()->GetClassPathName());
+        TArray<FAssetData> ChangedSets;
+        IAssetRegistry::GetChecked().GetAssets(Filter, ChangedSets);
+
+        for (const auto& SetData : ChangedSets)
+        {
+            const auto Set = Cast<UMetaWeaverMetadataDefinitionSet>(SetData.GetAsset());
+            if (!Set)
+            {
+                UE_LOG(LogMetaWeaver,
+                       Warning,
+                       TEXT("Failed to load changed definition set %s"),
+                       *SetData.GetObjectPathString());
+                return true;
+            }
+            for (const auto& ParameterSet : Set->ParameterSets)
+            {
+                if (!ParameterSet.ObjectType)
+                {
+                    return true;
+                }
+                OutAffectedClasses.AddUnique(ParameterSet.ObjectType->GetClassPathName());
+            }
+        }
+        return false;
+    }
+
+    bool IsUnderAnyPath(const FName PackageName, const TArray<FString>& Paths)
+    {
+        const auto Name = PackageName.ToString();
+        return Paths.ContainsByPredicate(
+            [&Name](const FString& Path) { return Name.StartsWith(Path + TEXT("/")) || Name == Path; });
+    }
+
+    void AccumulateTotals(const FMetaWeaverValidationReport& Report, FMetaWeaverBatchValidationReport& Totals)
+    {
+        int32 NumErrors{ 0 };
+        int32 NumWarnings{ 0 };
+        for (const auto& Issue : Report.Issues)
+        {
+            NumErrors += EMetaWeaverIssueSeverity::Error == Issue.Severity ? 1 : 0;
+            NumWarnings += EMetaWeaverIssueSeverity::Warning == Issue.Severity ? 1 : 0;
+        }
+        Totals.NumErrors += NumErrors;
+        Totals.NumWarnings += NumWarnings;
+        Totals.NumAssetsWithErrors += NumErrors > 0 ? 1 : 0;
+        Totals.NumAssetsWithWarnings += NumWarnings > 0 ? 1 : 0;
+        Totals.bHasErrors |= NumErrors > 0;
+    }
+} // namespace
+
+UMetaWeaverValidateCommandlet::UMetaWeaverValidateCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+    ShowErrorCount = true;
+
+    HelpDescription = TEXT("Validate asset metadata against the active MetaWeaver definition sets.");
+    HelpUsage = TEXT("UnrealEditor-Cmd <Project> -run=MetaWeaverValidate [-Paths=/Game/A+/Game/B] "
+                     "[-Classes=StaticMesh+Texture2D] [-ChangedFiles=<file>] [-Baseline=<report.jsonl>] "
+                     "[-Format=junit|sarif|jsonl] [-Output=<file>] [-Deep] [-BatchSize=<n>]");
+}
+
+int32 UMetaWeaverValidateCommandlet::Main(const FString& Params)
+{
+    const auto StartTime = FPlatformTime::Seconds();
+
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamValues;
+    ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+    FString Format{ TEXT("jsonl") };
+    if (const auto Found = ParamValues.Find(TEXT("Format")))
+    {
+        Format = *Found;
+    }
+    const auto Extension = FMetaWeaverReportWriter::GetExtension(Format);
+    if (Extension.IsEmpty())
+    {
+        UE_LOG(LogMetaWeaver, Error, TEXT("Unknown report format '%s'; expected junit, sarif or jsonl"), *Format);
+        return 1;
+    }
+
+    auto Output = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MetaWeaver"), TEXT("ValidationReport") + Extension);
+    if (const auto Found = ParamValues.Find(TEXT("Output")))
+    {
+        Output = FPaths::ConvertRelativePathToFull(*Found);
+    }
+
+    auto BatchSize = DefaultBatchSize;
+    if (const auto Found = ParamValues.Find(TEXT("BatchSize")))
+    {
+        BatchSize = FMath::Max(1, FCString::Atoi(**Found));
+    }
+
+    const auto Profile =
+        Switches.Contains(TEXT("Deep")) ? EMetaWeaverValidationProfile::Deep : EMetaWeaverValidationProfile::Fast;
+
+    // With a baseline only the differences to an earlier full report are written
+    TOptional<FMetaWeaverValidationBaseline> Baseline;
+    if (const auto BaselineFilename = ParamValues.Find(TEXT("Baseline")))
+    {
+        if (!Baseline.Emplace().Load(FPaths::ConvertRelativePathToFull(*BaselineFilename)))
+        {
+            return 1;
+        }
+    }
+
+    auto Paths = ParseList(ParamValues, TEXT("Paths"));
+    if (0 == Paths.Num())
+    {
+        Paths.Add(TEXT("/Game"));
+    }
+
+    FARFilter Filter;
+    Filter.bIncludeOnlyOnDiskAssets = true;
+    Filter.bRecursivePaths = true;
+    Filter.bRecursiveClasses = true;
+    for (const auto& Path : Paths)
+    {
+        Filter.PackagePaths.Add(FName(Path));
+    }
+    if (!ResolveClassPaths(ParseList(ParamValues, TEXT("Classes")), Filter.ClassPaths))
+    {
+        return 1;
+    }
+
+    // Commandlets do not search the asset registry in the background, so only scan what is going to be validated.
+    // With a changed file list that is the changed packages, plus the assets of the classes whose specs a changed
+    // definition set affects.
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    TArray<FAssetData> Assets;
+    TSet<FName> ChangedPackages;
+    auto bValidateAll{ true };
+    if (const auto ChangedFilesFilename = ParamValues.Find(TEXT("ChangedFiles")))
+    {
+        FChangedFiles Changed;
+        if (!ReadChangedFiles(*ChangedFilesFilename, Changed))
+        {
+            return 1;
+        }
+        AssetRegistry.ScanFilesSynchronous(Changed.PackageFilenames);
+        ChangedPackages.Append(Changed.PackageNames);
+
+        TArray<FTopLevelAssetPath> AffectedClasses;
+        if (Changed.bProjectSettingsChanged
+            || GatherClassesAffectedByDefinitionSets(Changed.PackageNames, AffectedClasses))
+        {
+            UE_LOG(LogMetaWeaver, Display, TEXT("Definitions for every class may have changed; validating all assets"));
+        }
+        else
+        {
+            bValidateAll = false;
+
+            // An empty package filter would match every asset
+            if (Changed.PackageNames.Num() > 0)
+            {
+                auto ChangedFilter = Filter;
+                ChangedFilter.PackageNames = Changed.PackageNames;
+                AssetRegistry.GetAssets(ChangedFilter, Assets);
+            }
+
+            if (AffectedClasses.Num() > 0)
+            {
+                UE_LOG(LogMetaWeaver,
+                       Display,
+                       TEXT("Changed definition sets affect %d classes; validating their assets"),
+                       AffectedClasses.Num());
+                AssetRegistry.ScanPathsSynchronous(Paths);
+
+                auto AffectedFilter = Filter;
+                AffectedFilter.ClassPaths = AffectedClasses;
+                TArray<FAssetData> AffectedAssets;
+                AssetRegistry.GetAssets(AffectedFilter, AffectedAssets);
+
+                // Keep honoring an explicit class filter
+                if (Filter.ClassPaths.Num() > 0)
+                {
+                    TSet<FTopLevelAssetPath> AllowedClasses;
+                    AssetRegistry.GetDerivedClassNames(Filter.ClassPaths, {}, AllowedClasses);
+                    AffectedAssets.RemoveAllSwap([&AllowedClasses](const FAssetData& AssetData) {
+                        return !AllowedClasses.Contains(AssetData.AssetClassPath);
+                    });
+                }
+                Assets.Append(MoveTemp(AffectedAssets));
+            }
+        }
+    }
+    if (bValidateAll)
+    {
+        AssetRegistry.ScanPathsSynchronous(Paths);
+        AssetRegistry.GetAssets(Filter, Assets);
+    }
+    Assets.RemoveAllSwap([](const FAssetData& AssetData) { return AssetData.IsRedirector(); });
+
+    // A stable order keeps reports of the same content identical between runs
+    Assets.Sort([](const FAssetData& A, const FAssetData& B) {
+        const auto Order = A.PackageName.Compare(B.PackageName);
+        return 0 != Order ? Order < 0 : A.AssetName.LexicalLess(B.AssetName);
+    });
+    Assets.SetNum(Algo::Unique(Assets, [](const FAssetData& A, const FAssetData& B) {
+        return A.PackageName == B.PackageName && A.AssetName == B.AssetName;
+    }));
+
+    const auto Subsystem = GEditor ? GEditor->GetEditorSubsystem<UMetaWeaverValidationSubsystem>() : nullptr;
+    if (!Subsystem)
+    {
+        UE_LOG(LogMetaWeaver, Error, TEXT("The MetaWeaver validation subsystem is not available"));
+        return 1;
+    }
+    Subsystem->WaitUntilDefinitionSetsReady();
+
+    const TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Output));
+    if (!Archive)
+    {
+        UE_LOG(LogMetaWeaver, Error, TEXT("Failed to open %s for writing"), *Output);
+        return 1;
+    }
+    const auto Writer = FMetaWeaverReportWriter::Create(Format, *Archive);
+    Writer->Begin();
+
+    UE_LOG(LogMetaWeaver, Display, TEXT("Validating metadata of %d assets"), Assets.Num());
+
+    // Relative to a baseline the totals count the new issues only
+    FMetaWeaverBatchValidationReport Totals;
+    int32 NumResolved{ 0 };
+    auto NumObjectsAtLastCollection = GUObjectArray.GetObjectArrayNumMinusAvailable();
+    for (int32 Start = 0; Start < Assets.Num(); Start += BatchSize)
+    {
+        // The checks of each batch run in parallel inside the subsystem
+        const auto Count = FMath::Min(BatchSize, Assets.Num() - Start);
+        const TArray<FAssetData> Chunk(Assets.GetData() + Start, Count);
+        const auto Batch = Subsystem->ValidateAssetData(Chunk, Profile);
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            if (Baseline.IsSet())
+            {
+                FMetaWeaverValidationReport New;
+                FMetaWeaverValidationReport Resolved;
+                Baseline->Compare(Batch.Reports[Index], New, Resolved);
+                Writer->Write(Chunk[Index], New, &Resolved);
+                AccumulateTotals(New, Totals);
+                NumResolved += Resolved.Issues.Num();
+            }
+            else
+            {
+                Writer->Write(Chunk[Index], Batch.Reports[Index]);
+                AccumulateTotals(Batch.Reports[Index], Totals);
+            }
+        }
+        UE_LOG(LogMetaWeaver, Display, TEXT("Validated %d/%d assets"), Start + Count, Assets.Num());
+
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+        if (NumObjects - NumObjectsAtLastCollection > GarbageCollectionObjectThreshold)
+        {
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+            NumObjectsAtLastCollection = GUObjectArray.GetObjectArrayNumMinusAvailable();
+        }
+    }
+
+    // Baseline assets in scope that were not validated are resolved only if they no longer exist. Assets the class
+    // filter excluded, or that were left out of a partial run, were simply not checked.
+    if (Baseline.IsSet())
+    {
+        Baseline->ForEachRemaining(
+            [&](const FSoftObjectPath& Asset, const FMetaWeaverValidationBaseline::FAssetIssues& AssetBaseline) {
+                const auto PackageName = Asset.GetLongPackageFName();
+                // ReSharper disable once CppTooWideScopeInitStatement
+                const auto bInScope =
+                    bValidateAll ? IsUnderAnyPath(PackageName, Paths) : ChangedPackages.Contains(PackageName);
+                if (bInScope && !AssetRegistry.GetAssetByObjectPath(Asset, /*bIncludeOnlyOnDiskAssets*/ true).IsValid())
+                {
+                    const FAssetData AssetData(PackageName,
+                                               FName(FPackageName::GetLongPackagePath(PackageName.ToString())),
+                                               FName(Asset.GetAssetName()),
+                                               AssetBaseline.Class);
+                    FMetaWeaverValidationReport New;
+                    New.Asset = Asset;
+                    FMetaWeaverValidationReport Resolved;
+                    Resolved.Asset = Asset;
+                    Resolved.Issues = AssetBaseline.Issues;
+                    Writer->Write(AssetData, New, &Resolved);
+                    NumResolved += Resolved.Issues.Num();
+                }
+            });
+    }
+
+    Writer->End();
+    if (!Archive->Close())
+    {
+        UE_LOG(LogMetaWeaver, Error, TEXT("Failed to write %s"), *Output);
+        return 1;
+    }
+
+    UE_LOG(LogMetaWeaver,
+           Display,
+           TEXT("Validated %d assets in %.1fs: %d %serrors in %d assets, %d %swarnings in %d assets. Report: %s"),
+           Assets.Num(),
+           FPlatformTime::Seconds() - StartTime,
+           Totals.NumErrors,
+           Baseline.IsSet() ? TEXT("new ") : TEXT(""),
+           Totals.NumAssetsWithErrors,
+           Totals.NumWarnings,
+           Baseline.IsSet() ? TEXT("new ") : TEXT(""),
+           Totals.NumAssetsWithWarnings,
+           *Output);
+    if (Baseline.IsSet())
+    {
+        UE_LOG(LogMetaWeaver, Display, TEXT("%d baseline issues were resolved"), NumResolved);
+    }
+    return Totals.NumErrors > 0 ? 1 : 0;
+}
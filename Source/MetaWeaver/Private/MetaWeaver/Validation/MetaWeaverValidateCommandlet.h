@@ -0,0 +1,42 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MetaWeaverValidateCommandlet.generated.h"
+
+/**
+ * Validates asset metadata from the command line, for build agents:
+ *
+ *   UnrealEditor-Cmd Project.uproject -run=MetaWeaverValidate [-Paths=/Game/A+/Game/B] [-Classes=StaticMesh]
+ *       [-ChangedFiles=Changes.txt] [-Baseline=Baseline.jsonl] [-Format=junit|sarif|jsonl] [-Output=Report.xml]
+ *       [-Deep] [-BatchSize=N]
+ *
+ * Assets are enumerated through the asset registry and validated in batches by UMetaWeaverValidationSubsystem,
+ * which reads projected metadata tags instead of loading assets. Each batch is streamed to the report as soon as it
+ * has been validated. With a changed file list only the changed packages and the assets affected by changed
+ * definition sets are validated. With a baseline report only new and resolved issues are written.
+ * Returns a non-zero exit code if any asset has (new) errors.
+ */
+UCLASS()
+class UMetaWeaverValidateCommandlet final : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UMetaWeaverValidateCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,161 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverValidationBaseline.h"
+#include "Dom/JsonObject.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/Class.h"
+
+namespace
+{
+    bool IsSameIssue(const FMetaWeaverIssue& A, const FMetaWeaverIssue& B)
+    {
+        return A.Key == B.Key && A.Code == B.Code && A.Argument == B.Argument && A.RelatedAsset == B.RelatedAsset;
+    }
+
+    template <typename EnumType>
+    bool TryParseEnum(const FString& Name, EnumType& OutValue)
+    {
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Value = StaticEnum<EnumType>()->GetValueByNameString(Name);
+        if (INDEX_NONE != Value)
+        {
+            OutValue = static_cast<EnumType>(Value);
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+bool FMetaWeaverValidationBaseline::Load(const FString& Filename)
+{
+    AssetsByPath.Reset();
+
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+    {
+        UE_LOG(LogMetaWeaver, Error, TEXT("Failed to read the baseline report %s"), *Filename);
+        return false;
+    }
+
+    int32 NumIssues{ 0 };
+    int32 NumSkipped{ 0 };
+    for (const auto& Line : Lines)
+    {
+        TSharedPtr<FJsonObject> Object;
+        if (Line.IsEmpty() || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Line), Object) || !Object)
+        {
+            ++NumSkipped;
+            continue;
+        }
+
+        FString Status;
+        if (Object->TryGetStringField(TEXT("status"), Status) && TEXT("resolved") == Status)
+        {
+            continue;
+        }
+
+        FString Asset;
+        FString Class;
+        FString Key;
+        FString Severity;
+        FString Code;
+        FString Argument;
+        Object->TryGetStringField(TEXT("class"), Class);
+        Object->TryGetStringField(TEXT("key"), Key);
+        Object->TryGetStringField(TEXT("argument"), Argument);
+
+        FMetaWeaverIssue Issue;
+        if (!Object->TryGetStringField(TEXT("asset"), Asset) || !Object->TryGetStringField(TEXT("code"), Code)
+            || !Object->TryGetStringField(TEXT("severity"), Severity) || !TryParseEnum(Code, Issue.Code)
+            || !TryParseEnum(Severity, Issue.Severity))
+        {
+            // Reports from a build with different issue codes can only be matched partially
+            ++NumSkipped;
+            continue;
+        }
+        Issue.Key = Key.IsEmpty() ? NAME_None : FName(Key);
+        if (EMetaWeaverIssueCode::DuplicateValue == Issue.Code)
+        {
+            Issue.RelatedAsset = FSoftObjectPath(Argument);
+        }
+        else
+        {
+            Issue.Argument = Argument.IsEmpty() ? NAME_None : FName(Argument);
+        }
+
+        auto& AssetIssues = AssetsByPath.FindOrAdd(FSoftObjectPath(Asset));
+        AssetIssues.Class = FTopLevelAssetPath(Class);
+        AssetIssues.Issues.Add(MoveTemp(Issue));
+        ++NumIssues;
+    }
+
+    if (NumSkipped > 0)
+    {
+        UE_LOG(LogMetaWeaver,
+               Warning,
+               TEXT("Skipped %d unreadable lines of the baseline report %s"),
+               NumSkipped,
+               *Filename);
+    }
+    UE_LOG(LogMetaWeaver,
+           Display,
+           TEXT("Loaded %d baseline issues of %d assets from %s"),
+           NumIssues,
+           AssetsByPath.Num(),
+           *Filename);
+    return true;
+}
+
+void FMetaWeaverValidationBaseline::Compare(const FMetaWeaverValidationReport& Report,
+                                           FMetaWeaverValidationReport& OutNew,
+                                           FMetaWeaverValidationReport& OutResolved)
+{
+    OutNew = FMetaWeaverValidationReport();
+    OutNew.Asset = Report.Asset;
+    OutResolved = FMetaWeaverValidationReport();
+    OutResolved.Asset = Report.Asset;
+
+    FAssetIssues Baseline;
+    AssetsByPath.RemoveAndCopyValue(Report.Asset, Baseline);
+
+    // Each baseline issue accounts for at most one reported issue, so duplicates are matched one to one
+    for (const auto& Issue : Report.Issues)
+    {
+        // ReSharper disable once CppTooWideScopeInitStatement
+        const auto Index = Baseline.Issues.IndexOfByPredicate(
+            [&Issue](const FMetaWeaverIssue& Existing) { return IsSameIssue(Issue, Existing); });
+        if (INDEX_NONE != Index)
+        {
+            Baseline.Issues.RemoveAt(Index);
+        }
+        else
+        {
+            OutNew.Issues.Add(Issue);
+            OutNew.bHasErrors |= EMetaWeaverIssueSeverity::Error == Issue.Severity;
+        }
+    }
+    OutResolved.Issues = MoveTemp(Baseline.Issues);
+}
+
+void FMetaWeaverValidationBaseline::ForEachRemaining(
+    TFunctionRef<void(const FSoftObjectPath& Asset, const FAssetIssues& Baseline)> Visitor) const
+{
+    for (const auto& AssetAndIssues : AssetsByPath)
+    {
+        Visitor(AssetAndIssues.Key, AssetAndIssues.Value);
+    }
+}
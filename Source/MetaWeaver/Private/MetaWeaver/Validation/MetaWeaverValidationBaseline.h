@@ -0,0 +1,53 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+
+/**
+ * The issues of an earlier validation run, read from a JSON Lines report, so that a run can report only the issues
+ * that are new or resolved. Issues are matched on asset, key, code and argument; messages and severities are not
+ * compared, so rewording a message does not make every issue new.
+ */
+class FMetaWeaverValidationBaseline final
+{
+public:
+    /** The baseline issues of one asset. */
+    struct FAssetIssues
+    {
+        FTopLevelAssetPath Class;
+        TArray<FMetaWeaverIssue> Issues;
+    };
+
+    /** Read a JSON Lines report written by the MetaWeaverValidate commandlet, skipping issues reported as resolved. */
+    bool Load(const FString& Filename);
+
+    /** Number of assets with issues in the baseline that have not been compared yet. */
+    int32 Num() const { return AssetsByPath.Num(); }
+
+    /**
+     * Split the report of an asset into the issues that are not in the baseline and the baseline issues that are no
+     * longer reported. The asset's baseline is consumed so that only assets that were not validated remain.
+     */
+    void Compare(const FMetaWeaverValidationReport& Report,
+                 FMetaWeaverValidationReport& OutNew,
+                 FMetaWeaverValidationReport& OutResolved);
+
+    /** Visit the baseline of every asset that has not been compared. */
+    void ForEachRemaining(TFunctionRef<void(const FSoftObjectPath& Asset, const FAssetIssues& Baseline)> Visitor) const;
+
+private:
+    TMap<FSoftObjectPath, FAssetIssues> AssetsByPath;
+};
@@ -0,0 +1,221 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "MetaWeaver/Validation/MetaWeaverValidationCache.h"
+#include "Hash/xxhash.h"
+#include "MetaWeaver/MetaWeaverLogging.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+namespace
+{
+    constexpr uint32 CacheMagic = 0x4D575643; // 'MWVC'
+
+    // Bump whenever the checks or the issues they produce change, so results from older builds are discarded
+    constexpr int32 CacheVersion = 5;
+
+    // The cache is discarded rather than evicted piecemeal once it grows past this many results
+    constexpr int32 MaxEntries = 256 * 1024;
+
+    FString GetCacheFilename()
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MetaWeaver"), TEXT("ValidationCache.bin"));
+    }
+
+    void SerializeEntries(FArchive& Ar, TMap<uint64, TArray<FMetaWeaverIssue>>& IssuesByKey)
+    {
+        FObjectAndNameAsStringProxyArchive Proxy(Ar, /*bInLoadIfFindFails*/ false);
+
+        // A damaged cache stops at the first error rather than sizing containers from garbage
+        const auto HasFailed = [&Ar, &Proxy]() { return Ar.IsError() || Proxy.IsError(); };
+
+        // Each entry and issue takes at least one byte, so a count the rest of the file can not hold is corrupt
+        const auto IsCountValid = [&Ar](const int32 Count) {
+            return Count >= 0 && Count <= Ar.TotalSize() - Ar.Tell();
+        };
+
+        int32 NumEntries = IssuesByKey.Num();
+        Proxy << NumEntries;
+        if (Proxy.IsLoading())
+        {
+            IssuesByKey.Reset();
+            if (HasFailed() || !IsCountValid(NumEntries))
+            {
+                Ar.SetError();
+                return;
+            }
+            IssuesByKey.Reserve(NumEntries);
+            for (int32 Index = 0; Index < NumEntries && !HasFailed(); ++Index)
+            {
+                uint64 Key{ 0 };
+                int32 NumIssues{ 0 };
+                Proxy << Key;
+                Proxy << NumIssues;
+                if (HasFailed() || !IsCountValid(NumIssues))
+                {
+                    Ar.SetError();
+                    return;
+                }
+                auto& Issues = IssuesByKey.Add(Key);
+                Issues.SetNum(NumIssues);
+                for (auto& Issue : Issues)
+                {
+                    FMetaWeaverIssue::StaticStruct()->SerializeItem(Proxy, &Issue, nullptr);
+                }
+            }
+            if (HasFailed())
+            {
+                Ar.SetError();
+            }
+        }
+        else
+        {
+            for (auto& Entry : IssuesByKey)
+            {
+                int32 NumIssues = Entry.Value.Num();
+                Proxy << Entry.Key;
+                Proxy << NumIssues;
+                for (auto& Issue : Entry.Value)
+                {
+                    FMetaWeaverIssue::StaticStruct()->SerializeItem(Proxy, &Issue, nullptr);
+                }
+            }
+        }
+    }
+} // namespace
+
+uint64 FMetaWeaverValidationCache::ComputeKey(const FMetaWeaverSpecTable& SpecTable, const TMap<FName, FString>& Tags)
+{
+    FXxHash64Builder Builder;
+    Builder.Update(&CacheVersion, sizeof(CacheVersion));
+    const auto ContentHash = SpecTable.GetContentHash();
+    Builder.Update(&ContentHash, sizeof(ContentHash));
+
+    // The specs are visited in table order, so the key does not depend on the order of the tag map
+    for (const auto& Spec : SpecTable.GetSpecs())
+    {
+        const auto Value = Tags.Find(Spec.Key);
+        const uint8 bPresent = nullptr != Value;
+        Builder.Update(&bPresent, sizeof(bPresent));
+        if (Value)
+        {
+            const int32 Length = Value->Len();
+            Builder.Update(&Length, sizeof(Length));
+            Builder.Update(**Value, Length * sizeof(TCHAR));
+        }
+    }
+    return Builder.Finalize().Hash;
+}
+
+bool FMetaWeaverValidationCache::Find(const uint64 Key, TArray<FMetaWeaverIssue>& OutIssues) const
+{
+    FReadScopeLock ReadLock(Lock);
+    if (const auto Found = IssuesByKey.Find(Key))
+    {
+        INC_DWORD_STAT(STAT_MetaWeaver_ValidationCacheHits);
+        ++NumHits;
+        OutIssues = *Found;
+        return true;
+    }
+    else
+    {
+        INC_DWORD_STAT(STAT_MetaWeaver_ValidationCacheMisses);
+        ++NumMisses;
+        return false;
+    }
+}
+
+void FMetaWeaverValidationCache::Add(const uint64 Key, const TArray<FMetaWeaverIssue>& Issues)
+{
+    FWriteScopeLock WriteLock(Lock);
+    if (IssuesByKey.Num() >= MaxEntries)
+    {
+        IssuesByKey.Reset();
+    }
+    IssuesByKey.Add(Key, Issues);
+    bDirty = true;
+}
+
+void FMetaWeaverValidationCache::Load()
+{
+    TArray<uint8> Bytes;
+    if (FFileHelper::LoadFileToArray(Bytes, *GetCacheFilename(), FILEREAD_Silent))
+    {
+        FMemoryReader Reader(Bytes, /*bIsPersistent*/ true);
+        uint32 Magic{ 0 };
+        int32 Version{ 0 };
+        Reader << Magic;
+        Reader << Version;
+        if (CacheMagic == Magic && CacheVersion == Version && !Reader.IsError())
+        {
+            FWriteScopeLock WriteLock(Lock);
+            SerializeEntries(Reader, IssuesByKey);
+            if (Reader.IsError())
+            {
+                UE_LOG(LogMetaWeaver,
+                       Warning,
+                       TEXT("Validation cache %s is corrupt; ignoring it"),
+                       *GetCacheFilename());
+                IssuesByKey.Reset();
+            }
+            else
+            {
+                UE_LOG(LogMetaWeaver, Verbose, TEXT("Loaded %d results from the validation cache"), IssuesByKey.Num());
+            }
+            bDirty = false;
+        }
+        else
+        {
+            UE_LOG(LogMetaWeaver, Verbose, TEXT("Validation cache has an unknown format; ignoring it"));
+        }
+    }
+}
+
+void FMetaWeaverValidationCache::Save()
+{
+    const int32 Hits = NumHits;
+    const int32 Lookups = Hits + NumMisses;
+    UE_CLOG(Lookups > 0,
+            LogMetaWeaver,
+            Log,
+            TEXT("Validation cache: %d of %d lookups hit (%.1f%%)"),
+            Hits,
+            Lookups,
+            100.0 * Hits / Lookups);
+
+    FWriteScopeLock WriteLock(Lock);
+    if (bDirty)
+    {
+        TArray<uint8> Bytes;
+        FMemoryWriter Writer(Bytes, /*bIsPersistent*/ true);
+        uint32 Magic{ CacheMagic };
+        int32 Version{ CacheVersion };
+        Writer << Magic;
+        Writer << Version;
+        SerializeEntries(Writer, IssuesByKey);
+
+        if (FFileHelper::SaveArrayToFile(Bytes, *GetCacheFilename()))
+        {
+            bDirty = false;
+        }
+        else
+        {
+            UE_LOG(LogMetaWeaver, Warning, TEXT("Failed to write validation cache %s"), *GetCacheFilename());
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+
+class FMetaWeaverSpecTable;
+
+/**
+ * Memoizes the issues found for an asset's metadata under a spec table, keyed by a content hash of both, and persists
+ * them in Saved/MetaWeaver so that an unchanged asset only costs a hash lookup, even in a later session.
+ * The key does not include the asset, as validation of the tags is a pure function of the tags and the specs.
+ * Results that depend on other assets (asset references) must not be added.
+ * Lookups and insertions are safe from any thread.
+ */
+class FMetaWeaverValidationCache final
+{
+public:
+    /** Hash the spec table and the values of the tags it defines. Tags the table does not define are ignored. */
+    static uint64 ComputeKey(const FMetaWeaverSpecTable& SpecTable, const TMap<FName, FString>& Tags);
+
+    bool Find(uint64 Key, TArray<FMetaWeaverIssue>& OutIssues) const;
+    void Add(uint64 Key, const TArray<FMetaWeaverIssue>& Issues);
+
+    /** Replace the contents with the cache persisted by an earlier session, if any. */
+    void Load();
+
+    /** Persist the cache if anything was added since it was loaded. */
+    void Save();
+
+private:
+    mutable FRWLock Lock;
+    TMap<uint64, TArray<FMetaWeaverIssue>> IssuesByKey;
+    bool bDirty{ false };
+
+    // Lookups since the cache was created, reported when it is saved
+    mutable std::atomic<int32> NumHits{ 0 };
+    mutable std::atomic<int32> NumMisses{ 0 };
+};
@@ -12,194 +12,885 @@
  * limitations under the License.
  */
 #include "MetaWeaver/Validation/MetaWeaverValidationSubsystem.h"
-#include "MetaWeaver/MetaWeaverAggregation.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StreamableManager.h"
+#include "MetaWeaver/MetaWeaverAssetReferences.h"
 #include "MetaWeaver/MetaWeaverMetadataDefinitionSet.h"
 #include "MetaWeaver/MetaWeaverMetadataStore.h"
 #include "MetaWeaver/MetaWeaverProjectSettings.h"
+#include "MetaWeaver/MetaWeaverSpecRegistry.h"
+#include "MetaWeaver/MetaWeaverSpecTable.h"
+#include "MetaWeaver/MetaWeaverStats.h"
+#include "MetaWeaver/MetaWeaverTagProjection.h"
 #include "MetaWeaver/MetaWeaverTypes.h"
+#include "MetaWeaver/Validation/MetaWeaverUniquenessIndex.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationCache.h"
+#include "Misc/PackageName.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverValidationSubsystem)
 
-// ReSharper disable once CppMemberFunctionMayBeStatic
+void UMetaWeaverValidationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SpecRegistry = MakeShared<FMetaWeaverSpecRegistry>();
+    SpecRegistry->GetOnCompiled().AddUObject(this, &UMetaWeaverValidationSubsystem::OnSpecRegistryCompiled);
+
+    ValidationCache = MakeShared<FMetaWeaverValidationCache>();
+    ValidationCache->Load();
+
+    // Keep the saved values of unique keys current without rescanning the project
+    UniquenessIndex = MakeShared<FMetaWeaverUniquenessIndex>();
+    PackageSavedHandle =
+        UPackage::PackageSavedWithContextEvent.AddUObject(this, &UMetaWeaverValidationSubsystem::OnPackageSaved);
+    MetadataChangedHandle = FMetaWeaverMetadataStore::OnMetadataChanged().AddUObject(
+        this,
+        &UMetaWeaverValidationSubsystem::OnMetadataChanged);
+    auto& AssetRegistry = IAssetRegistry::GetChecked();
+    AssetRemovedHandle =
+        AssetRegistry.OnAssetRemoved().AddUObject(this, &UMetaWeaverValidationSubsystem::OnAssetRemoved);
+    AssetRenamedHandle =
+        AssetRegistry.OnAssetRenamed().AddUObject(this, &UMetaWeaverValidationSubsystem::OnAssetRenamed);
+
+    // Project metadata into asset registry tags on save so assets can be validated without being loaded
+    ExtraObjectTagsHandle =
+        FCoreUObjectDelegates::GetExtraObjectTagsWithContext.AddStatic(&MetaWeaver::TagProjection::AppendProjectedTags);
+
+    // The registry is compiled from the project settings, so any settings change invalidates it
+    if (const auto Settings = GetMutableDefault<UMetaWeaverProjectSettings>())
+    {
+        ProjectSettingsChangedHandle =
+            Settings->OnSettingChanged().AddUObject(this, &UMetaWeaverValidationSubsystem::OnProjectSettingsChanged);
+    }
+
+    // Prefetch the definition set graph in the background once the asset registry has finished its initial scan.
+    // Commandlets load synchronously on first use instead.
+    if (!IsRunningCommandlet())
+    {
+        const auto& AssetRegistryModule =
+            FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+        if (AssetRegistryModule.Get().IsLoadingAssets())
+        {
+            FilesLoadedHandle = AssetRegistryModule.Get().OnFilesLoaded().AddUObject(
+                this,
+                &UMetaWeaverValidationSubsystem::OnAssetRegistryFilesLoaded);
+        }
+        else
+        {
+            SpecRegistry->BeginPreload();
+        }
+    }
+}
+
+void UMetaWeaverValidationSubsystem::Deinitialize()
+{
+    if (ProjectSettingsChangedHandle.IsValid())
+    {
+        if (const auto Settings = GetMutableDefault<UMetaWeaverProjectSettings>())
+        {
+            Settings->OnSettingChanged().Remove(ProjectSettingsChangedHandle);
+        }
+        ProjectSettingsChangedHandle.Reset();
+    }
+    if (FilesLoadedHandle.IsValid())
+    {
+        if (const auto Module = FModuleManager::Get().GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+        {
+            Module->Get().OnFilesLoaded().Remove(FilesLoadedHandle);
+        }
+        FilesLoadedHandle.Reset();
+    }
+    if (ExtraObjectTagsHandle.IsValid())
+    {
+        FCoreUObjectDelegates::GetExtraObjectTagsWithContext.Remove(ExtraObjectTagsHandle);
+        ExtraObjectTagsHandle.Reset();
+    }
+    UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+    FMetaWeaverMetadataStore::OnMetadataChanged().Remove(MetadataChangedHandle);
+    if (const auto AssetRegistry = IAssetRegistry::Get())
+    {
+        AssetRegistry->OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry->OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
+    UniquenessIndex.Reset();
+    if (ValidationCache.IsValid())
+    {
+        ValidationCache->Save();
+        ValidationCache.Reset();
+    }
+    SpecRegistry.Reset();
+
+    Super::Deinitialize();
+}
+
+FMetaWeaverSpecTableRef UMetaWeaverValidationSubsystem::GetSpecTableForClass(const UClass* Class) const
+{
+    if (Class && SpecRegistry.IsValid())
+    {
+        return SpecRegistry->GetSpecTableForClass(Class);
+    }
+    else
+    {
+        return FMetaWeaverSpecTable::Empty();
+    }
+}
+
 void UMetaWeaverValidationSubsystem::GatherSpecsForClass(const UClass* Class,
                                                          TArray<FMetadataParameterSpec>& OutSpecs) const
+{
+    OutSpecs = GetSpecTableForClass(Class)->GetSpecs();
+}
+
+bool UMetaWeaverValidationSubsystem::TryGatherSpecsForClass(const UClass* Class,
+                                                            TArray<FMetadataParameterSpec>& OutSpecs) const
 {
     OutSpecs.Reset();
-    if (Class)
+    if (!AreDefinitionSetsReady())
     {
-        TArray<UMetaWeaverMetadataDefinitionSet*> OrderedSets;
-        if (const auto Settings = GetDefault<UMetaWeaverProjectSettings>())
-        {
-            MetaWeaver::Aggregation::FlattenActiveSets(Settings->ActiveDefinitionSets, OrderedSets);
-        }
-        MetaWeaver::Aggregation::GatherSpecsForClassFromSets(Class, OrderedSets, OutSpecs);
+        return false;
+    }
+    else
+    {
+        GatherSpecsForClass(Class, OutSpecs);
+        return true;
     }
 }
 
-// ReSharper disable once CppMemberFunctionMayBeStatic
-void UMetaWeaverValidationSubsystem::ValidateAgainstSpecs(UObject* Asset,
-                                                          const TArray<FMetadataParameterSpec>& Specs,
-                                                          FMetaWeaverValidationReport& OutReport) const
+bool UMetaWeaverValidationSubsystem::AreDefinitionSetsReady() const
 {
-    if (Asset)
+    return SpecRegistry.IsValid() && SpecRegistry->IsCompiled();
+}
+
+void UMetaWeaverValidationSubsystem::WaitUntilDefinitionSetsReady() const
+{
+    if (SpecRegistry.IsValid())
     {
-        OutReport.Asset = Asset;
+        SpecRegistry->CompileIfRequired();
+    }
+}
 
-        // Build a map of current metadata
+namespace
+{
+    /**
+     * An AssetReference value whose class is checked after the parallel checks, as it needs the asset registry and,
+     * for deep validation, may load the referenced asset.
+     * IssueIndex is the position its issue would have had in the report, so results do not depend on threading.
+     */
+    struct FPendingAssetReference
+    {
+        const FMetadataParameterSpec* Spec{ nullptr };
+        FSoftObjectPath Path;
+        MetaWeaver::AssetReferences::EStatus Status{ MetaWeaver::AssetReferences::EStatus::Unknown };
+        int32 IssueIndex{ 0 };
+    };
+
+    /** Snapshot of one asset of a batch. Filled on the game thread and then checked on any thread. */
+    struct FValidationWorkItem
+    {
+        FMetaWeaverSpecTablePtr SpecTable;
         TMap<FName, FString> Tags;
-        FMetaWeaverMetadataStore::ListMetadataTags(Asset, Tags);
+        TArray<FPendingAssetReference> Pending;
+    };
+
+    void AddIssue(FMetaWeaverValidationReport& OutReport,
+                  const FName Key,
+                  const EMetaWeaverIssueSeverity Severity,
+                  const EMetaWeaverIssueCode Code,
+                  const FName Argument = NAME_None,
+                  const FSoftObjectPath& RelatedAsset = FSoftObjectPath())
+    {
+        FMetaWeaverIssue Issue;
+        Issue.Key = Key;
+        Issue.Severity = Severity;
+        Issue.Code = Code;
+        Issue.Argument = Argument;
+        Issue.RelatedAsset = RelatedAsset;
+        OutReport.Issues.Add(MoveTemp(Issue));
+        if (EMetaWeaverIssueSeverity::Error == Severity)
+        {
+            OutReport.bHasErrors = true;
+        }
+    }
 
-        for (const auto& Spec : Specs)
+    // Required, format and enum checks. Only reads the snapshot of the tags so it is safe on any thread.
+    void CheckTags(const FMetaWeaverSpecTable& SpecTable,
+                   const TMap<FName, FString>& Tags,
+                   FMetaWeaverValidationReport& OutReport,
+                   TArray<FPendingAssetReference>& OutPending)
+    {
+        for (const auto& Spec : SpecTable.GetSpecs())
         {
             const auto Found = Tags.Find(Spec.Key);
             if (!Found)
             {
                 if (Spec.bRequired)
                 {
-                    FMetaWeaverIssue Issue;
-                    Issue.Key = Spec.Key;
-                    Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                    Issue.Message = FText::FromString(TEXT("Required metadata key is missing."));
-                    OutReport.Issues.Add(MoveTemp(Issue));
-                    OutReport.bHasErrors = true;
+                    AddIssue(OutReport,
+                             Spec.Key,
+                             EMetaWeaverIssueSeverity::Error,
+                             EMetaWeaverIssueCode::RequiredKeyMissing);
                 }
                 continue;
             }
 
-            // Validate formatting/types using typed value canonicalization
-            if (FString Canonical; !FMetaWeaverValue::Canonicalize(Spec.Type, *Found, Canonical))
+            // Validate formatting/types using the validator compiled for the spec
+            const auto Result = SpecTable.GetValidator(Spec).Check(*Found);
+            if (EMetaWeaverValueCheck::Malformed == Result)
             {
-                FMetaWeaverIssue Issue;
-                Issue.Key = Spec.Key;
-                Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                Issue.Message =
-                    FText::FromString(TEXT("Metadata value is not correctly formatted for the expected type."));
-                OutReport.Issues.Add(MoveTemp(Issue));
-                OutReport.bHasErrors = true;
+                AddIssue(OutReport,
+                         Spec.Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::MalformedValue);
                 continue;
             }
 
             if (EMetaWeaverValueType::AssetReference == Spec.Type && Spec.AllowedClass)
             {
-                const FSoftObjectPath Path(*Found);
-                if (auto Resolved = Path.TryLoad())
+                auto& Pending = OutPending.AddDefaulted_GetRef();
+                Pending.Spec = &Spec;
+                Pending.Path = FSoftObjectPath(*Found);
+                Pending.IssueIndex = OutReport.Issues.Num();
+            }
+            else if (EMetaWeaverValueCheck::NotInEnum == Result)
+            {
+                AddIssue(OutReport,
+                         Spec.Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::NotInEnum);
+            }
+        }
+    }
+
+    // CheckTags memoized in the validation cache. Safe on any thread.
+    void CheckTagsCached(FMetaWeaverValidationCache* Cache,
+                         const FMetaWeaverSpecTable& SpecTable,
+                         const TMap<FName, FString>& Tags,
+                         FMetaWeaverValidationReport& OutReport,
+                         TArray<FPendingAssetReference>& OutPending)
+    {
+        if (!Cache)
+        {
+            CheckTags(SpecTable, Tags, OutReport, OutPending);
+        }
+        else
+        {
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Key = FMetaWeaverValidationCache::ComputeKey(SpecTable, Tags);
+            if (Cache->Find(Key, OutReport.Issues))
+            {
+                OutReport.bHasErrors = OutReport.Issues.ContainsByPredicate(
+                    [](const auto& Issue) { return EMetaWeaverIssueSeverity::Error == Issue.Severity; });
+            }
+            else
+            {
+                CheckTags(SpecTable, Tags, OutReport, OutPending);
+
+                // Asset reference checks depend on the state of other assets so those results are never cached.
+                // Whether a table and tags yield asset references is itself deterministic, so a hit never has any.
+                if (OutPending.IsEmpty())
+                {
+                    Cache->Add(Key, OutReport.Issues);
+                }
+            }
+        }
+    }
+
+    // Classify the deferred asset references from the asset registry. Deep validation then loads every reference
+    // the registry could not verify with a single request and classifies those again.
+    void ClassifyAssetReferences(const TArrayView<FValidationWorkItem> WorkItems,
+                                 const EMetaWeaverValidationProfile Profile)
+    {
+        using MetaWeaver::AssetReferences::EStatus;
+        check(IsInGameThread());
+
+        for (auto& WorkItem : WorkItems)
+        {
+            for (auto& Reference : WorkItem.Pending)
+            {
+                Reference.Status = MetaWeaver::AssetReferences::Check(Reference.Path, Reference.Spec->AllowedClass);
+            }
+        }
+
+        // Commandlets only scan what they validate, so referenced packages elsewhere in the project are scanned here
+        // and classified again rather than reported as unverified
+        if (IsRunningCommandlet())
+        {
+            auto& AssetRegistry = IAssetRegistry::GetChecked();
+            TSet<FString> Filenames;
+            TArray<FPendingAssetReference*> Unscanned;
+            for (auto& WorkItem : WorkItems)
+            {
+                for (auto& Reference : WorkItem.Pending)
                 {
-                    if (!Resolved->IsA(Spec.AllowedClass))
+                    FString Filename;
+                    if (EStatus::Unknown == Reference.Status && !Reference.Path.IsSubobject()
+                        && !AssetRegistry.GetAssetByObjectPath(Reference.Path).IsValid()
+                        && FPackageName::DoesPackageExist(Reference.Path.GetLongPackageName(), &Filename))
                     {
-                        FMetaWeaverIssue Issue;
-                        Issue.Key = Spec.Key;
-                        Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                        Issue.Message = FText::FromString(TEXT("Referenced asset is not of an allowed class."));
-                        OutReport.Issues.Add(MoveTemp(Issue));
-                        OutReport.bHasErrors = true;
+                        Filenames.Add(MoveTemp(Filename));
+                        Unscanned.Add(&Reference);
                     }
                 }
-                else
+            }
+            if (Filenames.Num() > 0)
+            {
+                AssetRegistry.ScanFilesSynchronous(Filenames.Array());
+                for (const auto Reference : Unscanned)
                 {
-                    // If it can't resolve, still flag formatting ok but warn about unresolved path
-                    FMetaWeaverIssue Issue;
-                    Issue.Key = Spec.Key;
-                    Issue.Severity = EMetaWeaverIssueSeverity::Warning;
-                    Issue.Message = FText::FromString(TEXT("Asset reference could not be resolved in editor."));
-                    OutReport.Issues.Add(MoveTemp(Issue));
+                    Reference->Status = MetaWeaver::AssetReferences::Check(Reference->Path,
+                                                                           Reference->Spec->AllowedClass);
                 }
             }
-            else if (EMetaWeaverValueType::Enum == Spec.Type)
+        }
+
+        TArray<FPendingAssetReference*> Unverified;
+        if (EMetaWeaverValidationProfile::Deep == Profile)
+        {
+            for (auto& WorkItem : WorkItems)
             {
-                bool bFoundInEnum = false;
-                for (const auto& V : Spec.EnumValues)
+                for (auto& Reference : WorkItem.Pending)
                 {
-                    if (Found->Equals(V, ESearchCase::CaseSensitive))
+                    if (EStatus::Missing == Reference.Status || EStatus::Unknown == Reference.Status)
                     {
-                        bFoundInEnum = true;
-                        break;
+                        Unverified.Add(&Reference);
                     }
                 }
-                if (!bFoundInEnum)
+            }
+        }
+
+        if (Unverified.Num() > 0)
+        {
+            TSet<FSoftObjectPath> Paths;
+            for (const auto Reference : Unverified)
+            {
+                Paths.Add(Reference->Path);
+            }
+            INC_DWORD_STAT_BY(STAT_MetaWeaver_AssetReferencesLoaded, Paths.Num());
+
+            FStreamableManager StreamableManager;
+            if (const auto Handle = StreamableManager.RequestAsyncLoad(Paths.Array()))
+            {
+                Handle->WaitUntilComplete();
+            }
+
+            for (const auto Reference : Unverified)
+            {
+                // Anything that still can not be verified after loading does not resolve to an asset
+                const auto Status = MetaWeaver::AssetReferences::Check(Reference->Path, Reference->Spec->AllowedClass);
+                Reference->Status = EStatus::Unknown == Status ? EStatus::Missing : Status;
+            }
+        }
+    }
+
+    // Insert the issues of the classified asset references where serial validation would have placed them.
+    void AddAssetReferenceIssues(const TArray<FPendingAssetReference>& Pending, FMetaWeaverValidationReport& OutReport)
+    {
+        using MetaWeaver::AssetReferences::EStatus;
+
+        // Walk backwards so earlier insertion points are not shifted by later insertions
+        for (int32 Index = Pending.Num() - 1; Index >= 0; --Index)
+        {
+            const auto& Reference = Pending[Index];
+            FMetaWeaverValidationReport Resolved;
+            if (EStatus::NotAllowed == Reference.Status)
+            {
+                AddIssue(Resolved,
+                         Reference.Spec->Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::AssetReferenceNotAllowedClass,
+                         Reference.Spec->AllowedClass->GetFName());
+            }
+            else if (EStatus::Missing == Reference.Status)
+            {
+                AddIssue(Resolved,
+                         Reference.Spec->Key,
+                         EMetaWeaverIssueSeverity::Warning,
+                         EMetaWeaverIssueCode::AssetReferenceUnresolved);
+            }
+            else if (EStatus::Unknown == Reference.Status)
+            {
+                AddIssue(Resolved,
+                         Reference.Spec->Key,
+                         EMetaWeaverIssueSeverity::Info,
+                         EMetaWeaverIssueCode::AssetReferenceUnverified);
+            }
+
+            if (Resolved.Issues.Num() > 0)
+            {
+                OutReport.Issues.Insert(MoveTemp(Resolved.Issues[0]), Reference.IssueIndex);
+                OutReport.bHasErrors |= Resolved.bHasErrors;
+            }
+        }
+    }
+
+    void SummarizeBatch(FMetaWeaverBatchValidationReport& OutBatch)
+    {
+        for (const auto& Report : OutBatch.Reports)
+        {
+            int32 Errors{ 0 };
+            int32 Warnings{ 0 };
+            for (const auto& Issue : Report.Issues)
+            {
+                if (EMetaWeaverIssueSeverity::Error == Issue.Severity)
+                {
+                    ++Errors;
+                }
+                else if (EMetaWeaverIssueSeverity::Warning == Issue.Severity)
                 {
-                    FMetaWeaverIssue Issue;
-                    Issue.Key = Spec.Key;
-                    Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                    Issue.Message = FText::FromString(TEXT("Value is not in the allowed enumeration list."));
-                    OutReport.Issues.Add(MoveTemp(Issue));
-                    OutReport.bHasErrors = true;
+                    ++Warnings;
                 }
             }
+            OutBatch.NumErrors += Errors;
+            OutBatch.NumWarnings += Warnings;
+            OutBatch.NumAssetsWithErrors += Errors > 0 ? 1 : 0;
+            OutBatch.NumAssetsWithWarnings += Warnings > 0 ? 1 : 0;
         }
+        OutBatch.bHasErrors = OutBatch.NumErrors > 0;
     }
-    else
+
+    /** Resolves the spec table of each class at most once per batch. */
+    class FBatchSpecTables
+    {
+    public:
+        explicit FBatchSpecTables(const UMetaWeaverValidationSubsystem& InSubsystem) : Subsystem(InSubsystem) {}
+
+        FMetaWeaverSpecTableRef Get(const UClass* Class)
+        {
+            if (const auto Found = ByClass.Find(Class))
+            {
+                return *Found;
+            }
+            else
+            {
+                return ByClass.Add(Class, Subsystem.GetSpecTableForClass(Class));
+            }
+        }
+
+    private:
+        const UMetaWeaverValidationSubsystem& Subsystem;
+        TMap<const UClass*, FMetaWeaverSpecTableRef> ByClass;
+    };
+
+    bool HasUniqueSpecs(const TArray<FValidationWorkItem>& WorkItems)
     {
+        return WorkItems.ContainsByPredicate([](const FValidationWorkItem& WorkItem) {
+            return WorkItem.SpecTable.IsValid() && WorkItem.SpecTable->HasUniqueSpecs();
+        });
+    }
+
+    // Collisions depend on the other assets, so these issues are added after the cached checks and never cached
+    void CheckUniqueness(const FMetaWeaverUniquenessIndex& Index,
+                         const FMetaWeaverSpecTable& SpecTable,
+                         const TMap<FName, FString>& Tags,
+                         FMetaWeaverValidationReport& OutReport)
+    {
+        if (SpecTable.HasUniqueSpecs())
+        {
+            for (const auto& [Key, Value] : Tags)
+            {
+                const auto Spec = SpecTable.Find(Key);
+                if (const auto Other =
+                        Spec ? Index.FindOtherAsset(SpecTable, *Spec, Value, OutReport.Asset) : FSoftObjectPath();
+                    Other.IsValid())
+                {
+                    AddIssue(OutReport,
+                             Key,
+                             EMetaWeaverIssueSeverity::Error,
+                             EMetaWeaverIssueCode::DuplicateValue,
+                             NAME_None,
+                             Other);
+                }
+            }
+        }
+    }
+
+    void RunBatchChecks(FMetaWeaverValidationCache* Cache,
+                        const FMetaWeaverUniquenessIndex* UniquenessIndex,
+                        TArray<FValidationWorkItem>& WorkItems,
+                        const EMetaWeaverValidationProfile Profile,
+                        FMetaWeaverBatchValidationReport& OutBatch)
+    {
+        // The checks only read the snapshots, the immutable spec tables and the index under its read lock
+        ParallelFor(WorkItems.Num(), [Cache, UniquenessIndex, &WorkItems, &OutBatch](const int32 Index) {
+            auto& WorkItem = WorkItems[Index];
+            auto& Report = OutBatch.Reports[Index];
+            if (WorkItem.SpecTable.IsValid())
+            {
+                CheckTagsCached(Cache, *WorkItem.SpecTable, WorkItem.Tags, Report, WorkItem.Pending);
+                if (UniquenessIndex)
+                {
+                    CheckUniqueness(*UniquenessIndex, *WorkItem.SpecTable, WorkItem.Tags, Report);
+                }
+            }
+        });
+
+        ClassifyAssetReferences(WorkItems, Profile);
+        for (int32 Index = 0; Index < WorkItems.Num(); ++Index)
+        {
+            AddAssetReferenceIssues(WorkItems[Index].Pending, OutBatch.Reports[Index]);
+        }
+
+        SummarizeBatch(OutBatch);
+    }
+} // namespace
+
+void UMetaWeaverValidationSubsystem::ValidateAgainstSpecs(UObject* Asset,
+                                                          const FMetaWeaverSpecTableRef& SpecTable,
+                                                          const EMetaWeaverValidationProfile Profile,
+                                                          FMetaWeaverValidationReport& OutReport) const
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_ValidateAgainstSpecs);
+
+    if (Asset)
+    {
+        INC_DWORD_STAT(STAT_MetaWeaver_AssetsValidated);
+        OutReport.Asset = Asset;
+
+        // The checks run here on the game thread, so the metadata is read in place rather than snapshotted
+        FValidationWorkItem WorkItem;
+        WorkItem.SpecTable = SpecTable;
+        const auto FoundTags = FMetaWeaverMetadataStore::FindMetadataTags(Asset);
+        const auto& Tags = FoundTags ? *FoundTags : WorkItem.Tags;
+
+        CheckTagsCached(ValidationCache.Get(), *SpecTable, Tags, OutReport, WorkItem.Pending);
+        if (SpecTable->HasUniqueSpecs())
+        {
+            CheckUniqueness(*GetUniquenessIndex(), *SpecTable, Tags, OutReport);
+        }
+        ClassifyAssetReferences(MakeArrayView(&WorkItem, 1), Profile);
+        AddAssetReferenceIssues(WorkItem.Pending, OutReport);
     }
 }
 
-FMetaWeaverValidationReport UMetaWeaverValidationSubsystem::ValidateAsset(UObject* Asset) const
+FMetaWeaverValidationReport
+UMetaWeaverValidationSubsystem::ValidateAsset(UObject* Asset, const EMetaWeaverValidationProfile Profile) const
 {
     FMetaWeaverValidationReport Report;
     if (Asset)
     {
-        TArray<FMetadataParameterSpec> Specs;
-        GatherSpecsForClass(Asset->GetClass(), Specs);
-        ValidateAgainstSpecs(Asset, Specs, Report);
+        const auto SpecTable = GetSpecTableForClass(Asset->GetClass());
+        ValidateAgainstSpecs(Asset, SpecTable, Profile, Report);
     }
     return Report;
 }
 
+FMetaWeaverBatchValidationReport
+UMetaWeaverValidationSubsystem::ValidateAssets(const TArray<UObject*>& Assets,
+                                               const EMetaWeaverValidationProfile Profile) const
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_ValidateAssets);
+    check(IsInGameThread());
+
+    FMetaWeaverBatchValidationReport Batch;
+    Batch.Reports.SetNum(Assets.Num());
+    TArray<FValidationWorkItem> WorkItems;
+    WorkItems.SetNum(Assets.Num());
+
+    // Resolve specs once per class and snapshot the metadata of every asset while on the game thread
+    FBatchSpecTables SpecTables(*this);
+    int32 NumValidated{ 0 };
+    for (int32 Index = 0; Index < Assets.Num(); ++Index)
+    {
+        if (const auto Asset = Assets[Index])
+        {
+            Batch.Reports[Index].Asset = Asset;
+            WorkItems[Index].SpecTable = SpecTables.Get(Asset->GetClass());
+            FMetaWeaverMetadataStore::ListMetadataTags(Asset, *WorkItems[Index].SpecTable, WorkItems[Index].Tags);
+            ++NumValidated;
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_MetaWeaver_AssetsValidated, NumValidated);
+
+    const auto Uniqueness = HasUniqueSpecs(WorkItems) ? GetUniquenessIndex() : nullptr;
+    RunBatchChecks(ValidationCache.Get(), Uniqueness, WorkItems, Profile, Batch);
+    return Batch;
+}
+
+FMetaWeaverBatchValidationReport
+UMetaWeaverValidationSubsystem::ValidateAssetData(const TArray<FAssetData>& Assets,
+                                                  const EMetaWeaverValidationProfile Profile) const
+{
+    METAWEAVER_SCOPE_CYCLE_COUNTER(STAT_MetaWeaver_ValidateAssets);
+    check(IsInGameThread());
+
+    FMetaWeaverBatchValidationReport Batch;
+    Batch.Reports.SetNum(Assets.Num());
+    TArray<FValidationWorkItem> WorkItems;
+    WorkItems.SetNum(Assets.Num());
+
+    FBatchSpecTables SpecTables(*this);
+    int32 NumValidated{ 0 };
+    for (int32 Index = 0; Index < Assets.Num(); ++Index)
+    {
+        const auto& AssetData = Assets[Index];
+        auto& Report = Batch.Reports[Index];
+        auto& WorkItem = WorkItems[Index];
+        Report.Asset = AssetData.ToSoftObjectPath();
+
+        // A loaded asset may have unsaved edits so its UMetaData is authoritative. Otherwise read the metadata
+        // projected into the asset registry when the package was saved and only load the asset as a last resort.
+        const auto Class = AssetData.GetClass();
+        if (const auto Loaded = AssetData.FastGetAsset(false))
+        {
+            WorkItem.SpecTable = SpecTables.Get(Loaded->GetClass());
+            FMetaWeaverMetadataStore::ListMetadataTags(Loaded, *WorkItem.SpecTable, WorkItem.Tags);
+            ++NumValidated;
+        }
+        else if (Class && 0 == SpecTables.Get(Class)->Num())
+        {
+            // Nothing is defined for the class, so there is nothing to check and no reason to load the asset
+            ++NumValidated;
+        }
+        else if (Class && FMetaWeaverMetadataStore::TryReadUnloadedMetadataTags(AssetData, WorkItem.Tags))
+        {
+            INC_DWORD_STAT(STAT_MetaWeaver_AssetsValidatedFromTags);
+            WorkItem.SpecTable = SpecTables.Get(Class);
+            ++NumValidated;
+        }
+        else if (const auto Asset = AssetData.GetAsset())
+        {
+            INC_DWORD_STAT(STAT_MetaWeaver_AssetsLoadedForValidation);
+            WorkItem.SpecTable = SpecTables.Get(Asset->GetClass());
+            FMetaWeaverMetadataStore::ListMetadataTags(Asset, *WorkItem.SpecTable, WorkItem.Tags);
+            ++NumValidated;
+        }
+        else
+        {
+            AddIssue(Report, NAME_None, EMetaWeaverIssueSeverity::Warning, EMetaWeaverIssueCode::AssetNotLoaded);
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_MetaWeaver_AssetsValidated, NumValidated);
+
+    const auto Uniqueness = HasUniqueSpecs(WorkItems) ? GetUniquenessIndex() : nullptr;
+    RunBatchChecks(ValidationCache.Get(), Uniqueness, WorkItems, Profile, Batch);
+    return Batch;
+}
+
+TSharedPtr<const FMetadataParameterSpec, ESPMode::ThreadSafe>
+UMetaWeaverValidationSubsystem::FindSpec(const UClass* Class, const FName Key) const
+{
+    const auto SpecTable = GetSpecTableForClass(Class);
+    if (const auto Spec = SpecTable->Find(Key))
+    {
+        // Alias the table so the spec stays valid for as long as the caller holds it
+        return TSharedPtr<const FMetadataParameterSpec, ESPMode::ThreadSafe>(SpecTable, Spec);
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
 FMetaWeaverValidationReport
 UMetaWeaverValidationSubsystem::ValidateKeyValue(TSubclassOf<UObject> Class, FName Key, const FString& Value) const
 {
     FMetaWeaverValidationReport Report;
     if (Class)
     {
-        TArray<FMetadataParameterSpec> Specs;
-        GatherSpecsForClass(Class, Specs);
+        const auto SpecTable = GetSpecTableForClass(Class);
+        if (const auto Spec = SpecTable->Find(Key))
+        {
+            // Basic formatting
+            const auto Result = SpecTable->GetValidator(*Spec).Check(Value);
+            if (Value.IsEmpty() || EMetaWeaverValueCheck::Malformed == Result)
+            {
+                AddIssue(Report,
+                         Spec->Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::MalformedValue);
+            }
+            else if (EMetaWeaverValueCheck::NotInEnum == Result)
+            {
+                AddIssue(Report,
+                         Spec->Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::NotInEnum);
+            }
+        }
+    }
+    return Report;
+}
+
+FMetaWeaverValidationReport UMetaWeaverValidationSubsystem::ValidateAssetKeyValue(const UObject* Asset,
+                                                                              const FName Key,
+                                                                              const FString& Value) const
+{
+    FMetaWeaverValidationReport Report;
+    if (Asset)
+    {
+        Report = ValidateKeyValue(Asset->GetClass(), Key, Value);
+        Report.Asset = Asset;
 
-        // Perform a direct spec lookup
-        for (const auto& Spec : Specs)
+        const auto SpecTable = GetSpecTableForClass(Asset->GetClass());
+        const auto Spec = Report.bHasErrors ? nullptr : SpecTable->Find(Key);
+        if (Spec && Spec->bUnique)
         {
-            if (Spec.Key == Key)
+            if (const auto Other = GetUniquenessIndex()->FindOtherAsset(*SpecTable, *Spec, Value, Report.Asset);
+                Other.IsValid())
             {
-                // ReSharper disable once CppTooWideScopeInitStatement
-                FString Canonical;
-                // Basic formatting
-                if (Value.IsEmpty() || !FMetaWeaverValue::Canonicalize(Spec.Type, Value, Canonical))
-                {
-                    FMetaWeaverIssue Issue;
-                    Issue.Key = Spec.Key;
-                    Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                    Issue.Message =
-                        FText::FromString(TEXT("Metadata value is not correctly formatted for the expected type."));
-                    Report.Issues.Add(MoveTemp(Issue));
-                    Report.bHasErrors = true;
-                }
-                else if (EMetaWeaverValueType::Enum == Spec.Type)
-                {
-                    bool bFoundInEnum = false;
-                    for (const auto& V : Spec.EnumValues)
-                    {
-                        if (Value.Equals(V, ESearchCase::CaseSensitive))
-                        {
-                            bFoundInEnum = true;
-                            break;
-                        }
-                    }
-                    if (!bFoundInEnum)
-                    {
-                        FMetaWeaverIssue Issue;
-                        Issue.Key = Spec.Key;
-                        Issue.Severity = EMetaWeaverIssueSeverity::Error;
-                        Issue.Message = FText::FromString(TEXT("Value is not in the allowed enumeration list."));
-                        Report.Issues.Add(MoveTemp(Issue));
-                        Report.bHasErrors = true;
-                    }
-                }
-                break;
+                AddIssue(Report,
+                         Key,
+                         EMetaWeaverIssueSeverity::Error,
+                         EMetaWeaverIssueCode::DuplicateValue,
+                         NAME_None,
+                         Other);
             }
         }
     }
     return Report;
 }
 
+FText UMetaWeaverValidationSubsystem::GetIssueMessage(const FMetaWeaverIssue& Issue)
+{
+    return Issue.GetMessage();
+}
+
 void UMetaWeaverValidationSubsystem::NotifyDefinitionSetsChanged() const
 {
-    DefinitionSetsChangedEvent.Broadcast();
+    if (SpecRegistry.IsValid())
+    {
+        SpecRegistry->Invalidate();
+    }
+    if (UniquenessIndex.IsValid())
+    {
+        UniquenessIndex->Invalidate();
+    }
+    DefinitionSetsChangedEvent.Broadcast(FMetaWeaverDefinitionSetsChange());
+}
+
+void UMetaWeaverValidationSubsystem::NotifyDefinitionSetChanged(const UMetaWeaverMetadataDefinitionSet* Set) const
+{
+    check(Set);
+
+    FMetaWeaverDefinitionSetsChange Change;
+    if (SpecRegistry.IsValid())
+    {
+        SpecRegistry->ApplyDefinitionSetChange(Set, Change);
+    }
+    else
+    {
+        Change.ChangedSet = Set;
+    }
+
+    // Saving or touching a set without altering any spec (or a set that is not active) need not disturb listeners
+    if (!Change.IsEmpty())
+    {
+        // Which keys are unique may have changed, and the index only records the keys that were
+        if (UniquenessIndex.IsValid())
+        {
+            UniquenessIndex->Invalidate();
+        }
+        DefinitionSetsChangedEvent.Broadcast(Change);
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnProjectSettingsChanged(UObject*, FPropertyChangedEvent&) const
+{
+    NotifyDefinitionSetsChanged();
+
+    // The active set list may have changed so start prefetching the new graph
+    if (SpecRegistry.IsValid() && !IsRunningCommandlet())
+    {
+        SpecRegistry->BeginPreload();
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnAssetRegistryFilesLoaded() const
+{
+    // An index built during the initial scan is missing the assets that had not been gathered yet
+    if (UniquenessIndex.IsValid())
+    {
+        UniquenessIndex->Invalidate();
+    }
+    if (SpecRegistry.IsValid() && !SpecRegistry->IsCompiled())
+    {
+        SpecRegistry->BeginPreload();
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnSpecRegistryCompiled() const
+{
+    DefinitionSetsReadyEvent.Broadcast();
+}
+
+const FMetaWeaverUniquenessIndex* UMetaWeaverValidationSubsystem::GetUniquenessIndex() const
+{
+    check(IsInGameThread());
+    check(UniquenessIndex.IsValid());
+
+    if (!UniquenessIndex->IsBuilt())
+    {
+        UniquenessIndex->Build([this](const UClass* Class) { return GetSpecTableForClass(Class); });
+    }
+    return UniquenessIndex.Get();
+}
+
+bool UMetaWeaverValidationSubsystem::BuildUniquenessIndex(const double EndTime) const
+{
+    check(IsInGameThread());
+    check(UniquenessIndex.IsValid());
+
+    return UniquenessIndex->BuildUntil([this](const UClass* Class) { return GetSpecTableForClass(Class); }, EndTime);
+}
+
+void UMetaWeaverValidationSubsystem::OnPackageSaved(const FString&, UPackage* Package, FObjectPostSaveContext) const
+{
+    // Package metadata becomes the saved value when the package is saved
+    if (!FMetaWeaverMetadataStore::IsPersistedOnWrite())
+    {
+        UpdateUniquenessIndex(Package);
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnMetadataChanged(const UPackage* Package) const
+{
+    // Sidecar metadata is saved as it is written
+    if (FMetaWeaverMetadataStore::IsPersistedOnWrite())
+    {
+        UpdateUniquenessIndex(Package);
+    }
+}
+
+void UMetaWeaverValidationSubsystem::UpdateUniquenessIndex(const UPackage* Package) const
+{
+    // An index that is not built yet reads the saved values when it is. One being built may already have read them.
+    if (Package && UniquenessIndex.IsValid() && (UniquenessIndex->IsBuilt() || UniquenessIndex->IsBuilding()))
+    {
+        const TMap<FName, FString> NoTags;
+        ForEachObjectWithPackage(
+            Package,
+            [this, &NoTags](UObject* Object) {
+                if (Object->IsAsset())
+                {
+                    const auto Tags = FMetaWeaverMetadataStore::FindMetadataTags(Object);
+                    UniquenessIndex->Update(FSoftObjectPath(Object),
+                                            *GetSpecTableForClass(Object->GetClass()),
+                                            Tags ? *Tags : NoTags);
+                }
+                return true;
+            },
+            /*bIncludeNestedObjects*/ false);
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnAssetRemoved(const FAssetData& AssetData) const
+{
+    if (UniquenessIndex.IsValid())
+    {
+        UniquenessIndex->Remove(AssetData.GetSoftObjectPath());
+    }
+}
+
+void UMetaWeaverValidationSubsystem::OnAssetRenamed(const FAssetData&, const FString& OldObjectPath) const
+{
+    // The asset is recorded under its new path when its package is saved
+    if (UniquenessIndex.IsValid())
+    {
+        UniquenessIndex->Remove(FSoftObjectPath(OldObjectPath));
+    }
 }
@@ -12,5 +12,95 @@
  * limitations under the License.
  */
 #include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+#include "UObject/Class.h"
+
+#define LOCTEXT_NAMESPACE "MetaWeaverValidationTypes"
+
+namespace
+{
+    constexpr int32 NumIssueCodes = static_cast<int32>(EMetaWeaverIssueCode::DuplicateValue) + 1;
+
+    /** Return the message of the code. Each message is built once and shared, as FText copies share their string. */
+    const FText& GetIssueMessage(const int32 Index)
+    {
+        // Indexed by EMetaWeaverIssueCode
+        static const FText Messages[] = {
+            LOCTEXT("RequiredKeyMissing", "Required metadata key is missing."),
+            LOCTEXT("MalformedValue", "Metadata value is not correctly formatted for the expected type."),
+            LOCTEXT("NotInEnum", "Value is not in the allowed enumeration list."),
+            LOCTEXT("AssetReferenceNotAllowedClass", "Referenced asset is not of an allowed class."),
+            LOCTEXT("AssetReferenceUnresolved", "Asset reference could not be resolved in editor."),
+            LOCTEXT("AssetReferenceUnverified",
+                    "Asset reference class could not be verified without loading. Use deep validation."),
+            LOCTEXT("AssetNotLoaded", "Asset could not be loaded."),
+            LOCTEXT("DuplicateValue", "Value must be unique but is already used by another asset."),
+        };
+        static_assert(UE_ARRAY_COUNT(Messages) == NumIssueCodes, "Every EMetaWeaverIssueCode needs a message");
+        return Messages[Index];
+    }
+} // namespace
+
+FText FMetaWeaverIssue::GetMessage() const
+{
+    const auto Index = static_cast<int32>(Code);
+    if (Index >= NumIssueCodes)
+    {
+        return FText::FromString(GetCodeName());
+    }
+    else if (EMetaWeaverIssueCode::AssetReferenceNotAllowedClass == Code && !Argument.IsNone())
+    {
+        return FText::Format(LOCTEXT("AssetReferenceNotAllowedClassWithClass",
+                                     "Referenced asset is not of an allowed class. Expected {0}."),
+                             FText::FromName(Argument));
+    }
+    else if (EMetaWeaverIssueCode::DuplicateValue == Code && RelatedAsset.IsValid())
+    {
+        return FText::Format(LOCTEXT("DuplicateValueWithAsset", "Value must be unique but is already used by {0}."),
+                             FText::FromString(RelatedAsset.ToString()));
+    }
+    else
+    {
+        return GetIssueMessage(Index);
+    }
+}
+
+FString FMetaWeaverIssue::GetCodeName() const
+{
+    return StaticEnum<EMetaWeaverIssueCode>()->GetNameStringByValue(static_cast<int64>(Code));
+}
+
+bool FMetaWeaverDefinitionSetsChange::IsEmpty() const
+{
+    return !bAffectsAll && !bAffectsAllClasses && 0 == AffectedObjectTypes.Num() && 0 == AffectedKeys.Num();
+}
+
+bool FMetaWeaverDefinitionSetsChange::AffectsClass(const UClass* Class) const
+{
+    if (bAffectsAll || bAffectsAllClasses)
+    {
+        return true;
+    }
+    else if (Class)
+    {
+        for (const auto& ObjectType : AffectedObjectTypes)
+        {
+            // A type that has been unloaded since the change was computed can no longer be matched, so be conservative
+            // ReSharper disable once CppTooWideScopeInitStatement
+            const auto Type = ObjectType.Get();
+            if (!Type || Class->IsChildOf(Type))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool FMetaWeaverDefinitionSetsChange::AffectsKey(const FName Key) const
+{
+    return bAffectsAll || AffectedKeys.Contains(Key);
+}
+
+#undef LOCTEXT_NAMESPACE
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(MetaWeaverValidationTypes)
@@ -0,0 +1,110 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/Ticker.h"
+#include "EditorSubsystem.h"
+#include "MetaWeaverMetadataIndexSubsystem.generated.h"
+
+class FObjectPostSaveContext;
+class UPackage;
+
+/**
+ * Persistent index of the metadata of every asset in the project, so tools can query metadata across the project
+ * without loading assets or walking the asset registry.
+ *
+ * The index is kept in Saved/MetaWeaver/MetadataIndex as one shard per content mount point of the project (/Game and
+ * each project plugin). Shards are memory-mapped when the subsystem starts, so queries are answered at once from the
+ * previous session's index. Once the asset registry has finished scanning, every package is checked against the
+ * version it was indexed at and stale packages are read again through FMetaWeaverMetadataStore within a per-frame
+ * budget. Saved packages (or, with sidecar storage, written metadata) are read again on the next tick. Changes are
+ * served from memory and written to their shard on a worker thread once edits settle.
+ *
+ * The index holds persisted metadata: edits to package metadata are indexed once the package is saved. Values are
+ * indexed as stored, in canonical form. Queries are game thread only.
+ */
+UCLASS()
+class UMetaWeaverMetadataIndexSubsystem : public UEditorSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Copy the indexed tags of the asset. Returns false if the asset has no indexed tags.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    bool GetIndexedTags(const FSoftObjectPath& Asset, TMap<FName, FString>& OutTags) const;
+
+    // Find the indexed value of a key of the asset. Returns false if the asset has no indexed value for the key.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    bool GetIndexedValue(const FSoftObjectPath& Asset, FName Key, FString& OutValue) const;
+
+    // Return every indexed asset that defines the key
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    TArray<FSoftObjectPath> FindAssetsWithKey(FName Key) const;
+
+    // Return every indexed asset whose value for the key is exactly the value
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    TArray<FSoftObjectPath> FindAssetsWithValue(FName Key, const FString& Value) const;
+
+    // Whether every package has been checked against the index since the editor started and none is waiting
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    bool IsUpToDate() const;
+
+    // Number of packages waiting to be checked or read
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Metadata Index")
+    int32 GetNumPending() const;
+
+private:
+    struct FShard;
+
+    bool Tick(float DeltaTime);
+    void QueueVerification();
+    bool IsStale(FName PackageName) const;
+    void ReadPackage(FName PackageName);
+    static void BeginWrite(FShard& Shard);
+    static void FinishWrite(FShard& Shard);
+    FShard* FindShard(FName PackageName) const;
+    TArray<FSoftObjectPath> FindAssets(FName Key, const FString* Value) const;
+
+    void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext);
+    void OnMetadataChanged(const UPackage* Package);
+    void OnAssetRemoved(const FAssetData& AssetData);
+    void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+    TArray<TSharedRef<FShard>> Shards;
+
+    // Packages to read again on the next tick
+    TSet<FName> StalePackages;
+
+    // Packages still to be checked against the index, from VerifyCursor on
+    TArray<FName> VerifyQueue;
+    int32 VerifyCursor{ 0 };
+
+    // The index is checked once the asset registry has finished its initial scan
+    bool bVerificationRequested{ true };
+
+    // Identifies each read of a package, so a read that lands while its shard is written is kept
+    uint64 NextReadSerial{ 0 };
+
+    FTSTicker::FDelegateHandle TickerHandle;
+    FDelegateHandle PackageSavedHandle;
+    FDelegateHandle MetadataChangedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+};
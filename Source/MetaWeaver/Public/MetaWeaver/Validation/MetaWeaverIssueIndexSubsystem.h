@@ -0,0 +1,110 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/Ticker.h"
+#include "EditorSubsystem.h"
+#include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
+#include "MetaWeaverIssueIndexSubsystem.generated.h"
+
+class FObjectPostSaveContext;
+class UPackage;
+class UMetaWeaverValidationSubsystem;
+
+/**
+ * Keeps an index of the metadata issues of every asset in the project up to date while the editor runs, so tools can
+ * query the assets that currently fail the metadata rules without validating anything.
+ *
+ * Saved and modified packages are revalidated on the next tick. The rest of the project is swept in slices within a
+ * per-frame time budget once the asset registry and the definition sets are ready, and the affected classes are swept
+ * again whenever a definition set changes. The sweep never loads assets: assets saved without a metadata projection
+ * are indexed once they are loaded or saved.
+ */
+UCLASS()
+class UMetaWeaverIssueIndexSubsystem : public UEditorSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Fired on the game thread after a tick that changed the index
+    DECLARE_MULTICAST_DELEGATE(FOnIssueIndexChanged);
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Return the report of every indexed asset with at least one issue of the severity or a more severe one
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    TArray<FMetaWeaverValidationReport>
+    GetFailingAssets(EMetaWeaverIssueSeverity MinSeverity = EMetaWeaverIssueSeverity::Error) const;
+
+    // Find the indexed report of the asset. Returns false if the asset has no known issues.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    bool FindReport(const FSoftObjectPath& Asset, FMetaWeaverValidationReport& OutReport) const;
+
+    // Whether every asset in the project has been visited since the index was created or the definitions changed
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    bool IsSweepComplete() const { return bSweepComplete; }
+
+    // Number of packages and assets waiting to be validated
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    int32 GetNumPending() const;
+
+    // Accessor for the index-changed event
+    FOnIssueIndexChanged& GetOnIssueIndexChanged() { return IssueIndexChangedEvent; }
+
+private:
+    bool Tick(float DeltaTime);
+    void QueueSweep(const FMetaWeaverDefinitionSetsChange* Change);
+    bool ValidateSlice(const TArray<FAssetData>& Slice);
+    bool SetReport(FName PackageName, FMetaWeaverValidationReport&& Report);
+    bool RemoveReport(FName PackageName, const FSoftObjectPath& Asset);
+
+    void OnObjectModified(UObject* Object);
+    void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext);
+    void OnMetadataChanged(const UPackage* Package);
+    void OnAssetRemoved(const FAssetData& AssetData);
+    void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+    void OnDefinitionSetsChanged(const FMetaWeaverDefinitionSetsChange& Change);
+
+    UPROPERTY(Transient)
+    TObjectPtr<UMetaWeaverValidationSubsystem> ValidationSubsystem;
+
+    FOnIssueIndexChanged IssueIndexChangedEvent;
+
+    // Reports of the assets with issues, grouped by package so a revalidated package replaces its reports as a whole
+    TMap<FName, TArray<FMetaWeaverValidationReport>> ReportsByPackage;
+
+    // Packages saved or modified since they were last validated. They take priority over the sweep.
+    TSet<FName> DirtyPackages;
+
+    // Assets still to be visited by the sweep, from SweepCursor on, and their paths so none is queued twice
+    TArray<FAssetData> SweepQueue;
+    TSet<FSoftObjectPath> SweepQueued;
+    int32 SweepCursor{ 0 };
+
+    // A full sweep is started once the asset registry has finished its initial scan
+    bool bFullSweepRequested{ true };
+    bool bSweepComplete{ false };
+
+    FTSTicker::FDelegateHandle TickerHandle;
+    FDelegateHandle ObjectModifiedHandle;
+    FDelegateHandle PackageSavedHandle;
+    FDelegateHandle MetadataChangedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle DefinitionSetsChangedHandle;
+};
@@ -14,11 +14,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "EditorSubsystem.h"
 #include "MetaWeaver/Validation/MetaWeaverValidationTypes.h"
 #include "MetaWeaverValidationSubsystem.generated.h"
 
+class FMetaWeaverSpecRegistry;
+class FMetaWeaverSpecTable;
+class FMetaWeaverUniquenessIndex;
+class FMetaWeaverValidationCache;
+class FObjectPostSaveContext;
 class UMetaWeaverMetadataDefinitionSet;
 struct FMetadataParameterSpec;
+struct FPropertyChangedEvent;
 
 /**
  * Public validation API for other editor modules to consume.
@@ -31,28 +39,127 @@ class UMetaWeaverValidationSubsystem : public UEditorSubsystem
 
 public:
     // Fired when any definition set is edited or saved, so UIs can refresh specs.
-    DECLARE_MULTICAST_DELEGATE(FOnDefinitionSetsChanged);
+    // The change describes the affected classes and keys so listeners can refresh selectively.
+    DECLARE_MULTICAST_DELEGATE_OneParam(FOnDefinitionSetsChanged, const FMetaWeaverDefinitionSetsChange&);
 
-    // Validate a single asset using active project definition sets
+    // Fired when the active definition sets have been loaded and compiled and specs can be gathered without loading.
+    DECLARE_MULTICAST_DELEGATE(FOnDefinitionSetsReady);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Validate a single asset using active project definition sets.
+    // The fast profile checks asset references against the asset registry; the deep profile also loads references
+    // that the asset registry can not verify.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    FMetaWeaverValidationReport
+    ValidateAsset(UObject* Asset, EMetaWeaverValidationProfile Profile = EMetaWeaverValidationProfile::Fast) const;
+
+    // Validate many assets at once. Specs are resolved once per class, the metadata is snapshotted on the game thread
+    // and the checks run in parallel. Null entries produce an empty report so reports line up with the input.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    FMetaWeaverBatchValidationReport
+    ValidateAssets(const TArray<UObject*>& Assets,
+                   EMetaWeaverValidationProfile Profile = EMetaWeaverValidationProfile::Fast) const;
+
+    // Validate many assets identified by asset data. Unloaded assets are validated from the metadata projected into
+    // their asset registry tags and are only loaded if they were saved without a projection. Assets of classes without
+    // specs are never loaded. Assets that fail to load are reported with a warning. With the deep profile every
+    // unverified asset reference in the batch is loaded by a single request.
     UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
-    FMetaWeaverValidationReport ValidateAsset(UObject* Asset) const;
+    FMetaWeaverBatchValidationReport
+    ValidateAssetData(const TArray<FAssetData>& Assets,
+                      EMetaWeaverValidationProfile Profile = EMetaWeaverValidationProfile::Fast) const;
 
     // Validate a single key/value for the specified class
     UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
     FMetaWeaverValidationReport ValidateKeyValue(TSubclassOf<UObject> Class, FName Key, const FString& Value) const;
 
+    // Validate a single key/value for the asset. Like ValidateKeyValue, but a unique key is also checked against the
+    // values saved on every other asset, so editors can reject a collision before it is committed.
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    FMetaWeaverValidationReport ValidateAssetKeyValue(const UObject* Asset, FName Key, const FString& Value) const;
+
+    // Return the localized message for an issue. Reports only carry issue codes until they are displayed.
+    UFUNCTION(BlueprintPure, Category = "MetaWeaver|Validation")
+    static FText GetIssueMessage(const FMetaWeaverIssue& Issue);
+
+    // Return the shared, immutable spec table for the class without copying any specs.
+    // Blocks until the definition sets are loaded if they are not ready.
+    TSharedRef<const FMetaWeaverSpecTable, ESPMode::ThreadSafe> GetSpecTableForClass(const UClass* Class) const;
+
+    // Return the effective spec for the key on the class, or null if the class does not define the key. A hash lookup
+    // in the class's spec table. The result shares ownership of the table so it remains valid while it is held.
+    TSharedPtr<const FMetadataParameterSpec, ESPMode::ThreadSafe> FindSpec(const UClass* Class, FName Key) const;
+
+    // Gather a copy of the effective specs for the class.
+    // Blocks until the definition sets are loaded if they are not ready.
     void GatherSpecsForClass(const UClass* Class, TArray<FMetadataParameterSpec>& OutSpecs) const;
 
-    // Notify listeners that definition sets changed; used by asset classes on edits/saves
+    // Gather the effective specs for the class without blocking.
+    // Returns false (and no specs) if the definition sets are still being preloaded.
+    bool TryGatherSpecsForClass(const UClass* Class, TArray<FMetadataParameterSpec>& OutSpecs) const;
+
+    // Whether the active definition sets have been loaded and compiled
+    UFUNCTION(BlueprintCallable, Category = "MetaWeaver|Validation")
+    bool AreDefinitionSetsReady() const;
+
+    // Block until the active definition sets have been loaded and compiled
+    void WaitUntilDefinitionSetsReady() const;
+
+    // Accessor for the definition-ready event
+    FOnDefinitionSetsReady& GetOnDefinitionSetsReady() { return DefinitionSetsReadyEvent; }
+
+    // Invalidate the compiled spec registry and notify listeners that every definition may have changed.
     void NotifyDefinitionSetsChanged() const;
 
+    // Patch the compiled spec registry for a single edited or saved set and notify listeners of the affected
+    // classes and keys. Used by asset classes on edits/saves.
+    void NotifyDefinitionSetChanged(const UMetaWeaverMetadataDefinitionSet* Set) const;
+
     // Accessor for the definition-changed event
     FOnDefinitionSetsChanged& GetOnDefinitionSetsChanged() { return DefinitionSetsChangedEvent; }
 
+    // Build the index of unique values until EndTime (in FPlatformTime::Seconds()) and return true once it is built.
+    // Lets callers that validate over many frames build it within their own budget instead of the first validation
+    // of a unique key building it all at once. Game thread only.
+    bool BuildUniquenessIndex(double EndTime) const;
+
 private:
     void ValidateAgainstSpecs(UObject* Asset,
-                              const TArray<FMetadataParameterSpec>& Specs,
+                              const TSharedRef<const FMetaWeaverSpecTable, ESPMode::ThreadSafe>& SpecTable,
+                              EMetaWeaverValidationProfile Profile,
                               FMetaWeaverValidationReport& OutReport) const;
 
+    // Return the uniqueness index, building it first if required. Game thread only.
+    const FMetaWeaverUniquenessIndex* GetUniquenessIndex() const;
+
+    void OnProjectSettingsChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent) const;
+    void OnAssetRegistryFilesLoaded() const;
+    void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext) const;
+    void OnMetadataChanged(const UPackage* Package) const;
+    void UpdateUniquenessIndex(const UPackage* Package) const;
+    void OnAssetRemoved(const FAssetData& AssetData) const;
+    void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath) const;
+    void OnSpecRegistryCompiled() const;
+
     FOnDefinitionSetsChanged DefinitionSetsChangedEvent;
+    FOnDefinitionSetsReady DefinitionSetsReadyEvent;
+
+    // Flattened definition sets and memoized per-class specs. Only invalidated when definitions or settings change.
+    TSharedPtr<FMetaWeaverSpecRegistry> SpecRegistry;
+
+    // Validation results keyed by the content of the metadata and specs, persisted between sessions
+    TSharedPtr<FMetaWeaverValidationCache> ValidationCache;
+
+    // Saved values of unique keys across the project. Built on first use and kept current from package saves.
+    TSharedPtr<FMetaWeaverUniquenessIndex> UniquenessIndex;
+
+    FDelegateHandle ProjectSettingsChangedHandle;
+    FDelegateHandle FilesLoadedHandle;
+    FDelegateHandle ExtraObjectTagsHandle;
+    FDelegateHandle PackageSavedHandle;
+    FDelegateHandle MetadataChangedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
 };
@@ -16,6 +16,8 @@
 #include "CoreMinimal.h"
 #include "MetaWeaverValidationTypes.generated.h"
 
+class UMetaWeaverMetadataDefinitionSet;
+
 UENUM(BlueprintType)
 enum class EMetaWeaverIssueSeverity : uint8
 {
@@ -24,6 +26,40 @@ enum class EMetaWeaverIssueSeverity : uint8
     Info
 };
 
+/**
+ * Identifies what an issue reports. Codes are stable and are what machine consumers (CI, caches) should match on;
+ * the localized message is only built when an issue is displayed.
+ */
+UENUM(BlueprintType)
+enum class EMetaWeaverIssueCode : uint8
+{
+    // A required key has no value
+    RequiredKeyMissing,
+    // The value does not parse as the type of the spec
+    MalformedValue,
+    // The value is not listed by an exclusive enumeration
+    NotInEnum,
+    // The referenced asset is not of the allowed class. Argument is the name of the allowed class
+    AssetReferenceNotAllowedClass,
+    // The referenced asset could not be found
+    AssetReferenceUnresolved,
+    // The class of the referenced asset could not be verified without loading it
+    AssetReferenceUnverified,
+    // The asset itself could not be loaded for validation
+    AssetNotLoaded,
+    // Another asset already uses the value of a unique key. RelatedAsset is the other asset
+    DuplicateValue
+};
+
+UENUM(BlueprintType)
+enum class EMetaWeaverValidationProfile : uint8
+{
+    // Check asset references against the asset registry without loading them
+    Fast,
+    // Also load the asset references that the asset registry could not verify
+    Deep
+};
+
 USTRUCT(BlueprintType)
 struct FMetaWeaverIssue
 {
@@ -36,7 +72,24 @@ struct FMetaWeaverIssue
     EMetaWeaverIssueSeverity Severity{ EMetaWeaverIssueSeverity::Error };
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
-    FText Message;
+    EMetaWeaverIssueCode Code{ EMetaWeaverIssueCode::MalformedValue };
+
+    // Optional parameter of the message, as described by the code. Only used for names, such as a class name.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    FName Argument{ NAME_None };
+
+    // Optional asset the issue refers to, as described by the code
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    FSoftObjectPath RelatedAsset;
+
+    /**
+     * Return the localized message for the issue.
+     * Messages without an argument are shared between every issue with the same code.
+     */
+    FText GetMessage() const;
+
+    /** Return the stable, non-localized name of the code, e.g. "RequiredKeyMissing". */
+    FString GetCodeName() const;
 };
 
 USTRUCT(BlueprintType)
@@ -53,3 +106,59 @@ struct FMetaWeaverValidationReport
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
     bool bHasErrors{ false };
 };
+
+USTRUCT(BlueprintType)
+struct FMetaWeaverBatchValidationReport
+{
+    GENERATED_BODY()
+
+    // One report per input asset, in the order the assets were supplied
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    TArray<FMetaWeaverValidationReport> Reports;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    int32 NumAssetsWithErrors{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    int32 NumAssetsWithWarnings{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    int32 NumErrors{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    int32 NumWarnings{ 0 };
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "MetaWeaver")
+    bool bHasErrors{ false };
+};
+
+/**
+ * Describes the part of the compiled definitions affected by a definition set change,
+ * so listeners can refresh only the classes and keys that were touched.
+ */
+struct FMetaWeaverDefinitionSetsChange
+{
+    /** The definition set that was edited or saved, if the change originated from a single set. */
+    TWeakObjectPtr<const UMetaWeaverMetadataDefinitionSet> ChangedSet;
+
+    /** True if every class and key must be considered affected (e.g. the settings or include graph changed). */
+    bool bAffectsAll{ true };
+
+    /** True if a parameter set without an ObjectType changed, which affects every class. */
+    bool bAffectsAllClasses{ false };
+
+    /** ObjectTypes whose parameter sets changed. Subclasses of these types are affected as well. */
+    TArray<TWeakObjectPtr<const UClass>> AffectedObjectTypes;
+
+    /** Keys whose specs were added, removed or modified. */
+    TSet<FName> AffectedKeys;
+
+    /** Return true if nothing compiled from the active definition sets was affected. */
+    bool IsEmpty() const;
+
+    /** Return true if the specs resolved for the class may have changed. */
+    bool AffectsClass(const UClass* Class) const;
+
+    /** Return true if the spec for the key may have changed. */
+    bool AffectsKey(FName Key) const;
+};